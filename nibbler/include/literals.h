@@ -10,4 +10,8 @@ namespace literals {
     constexpr size_t BOARD_MINIMUM_WIDTH = 10;
     /** @brief Board minimum height required to play the game */
     constexpr size_t BOARD_MINIMUM_HEIGHT = 10;
+    /** @brief Board maximum number of cells, e.g. 32768x32768. The occupancy bitboard alone takes 128 MiB */
+    constexpr size_t BOARD_MAXIMUM_CELLS = size_t(1) << 30;
+    /** @brief Autopilot maximum number of cells, e.g. 2048x2048. Its search buffers take 20 bytes per cell */
+    constexpr size_t AUTOPILOT_MAXIMUM_CELLS = size_t(1) << 22;
 }  // namespace literals
@@ -3,6 +3,7 @@
 #include <functional>
 #include <future>
 #include <string>
+#include <vector>
 
 #include "game/Menu.h"
 
@@ -14,6 +15,39 @@ namespace interface {
 
     using ARGB = uint32_t;
 
+    /** @brief Size of a frame buffer, in pixels. */
+    struct Extent {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    /** @brief Axis-aligned rectangle inside a frame buffer, in pixels. */
+    struct Rect {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    /** @brief Memory layout of a single pixel. */
+    enum class PixelFormat : uint8_t {
+        ARGB8888  ///< One uint32_t per pixel, 0xAARRGGBB
+    };
+
+    /** @brief Writable pixel memory owned by the plugin, see IPlugin::acquire_surface(). */
+    struct Surface {
+        /** @brief First pixel of the first row */
+        ARGB *pixels;
+        /** @brief Distance between the start of two consecutive rows, in pixels */
+        size_t stride;
+        /** @brief Dimensions of the surface */
+        Extent extent;
+        /** @brief Layout of each pixel */
+        PixelFormat format;
+        /** @brief true if the surface still holds the last presented frame, false if it must be fully repainted */
+        bool preserved;
+    };
+
     /** @brief Enum class representing keys from the keyboard. */
     enum class Input : uint8_t {
         A,            ///< Key 'A'
@@ -151,9 +185,74 @@ namespace interface {
          * buffer, so the only responsibility of the plugin is to render the given buffer. The plugin does not know
          * about the game state and does not need to know.
          *
+         * The buffer is row-major, tightly packed, and holds extent.width * extent.height pixels.
+         *
+         * @param buffer The buffer containing the game's pixel data in ARGB format.
+         * @param extent The dimensions of the buffer.
+         */
+        virtual void display_game(std::vector<ARGB> const &buffer, Extent extent) = 0;
+
+        /**
+         * @brief The size of a board cell in the game frames sent to the plugin, in pixels.
+         *
+         * A plugin drawing cells its own way (e.g. one character per cell in a terminal) asks for {1, 1}, and gets
+         * one pixel per cell. The default {0, 0} lets the application pick the scale.
+         */
+        virtual Extent cell_size() { return {0, 0}; }
+
+        /**
+         * @brief Display the parts of the Snake game that changed since the previous frame.
+         *
+         * This function will be called by the application instead of display_game() when only a few regions of the
+         * frame changed. The buffer always holds the complete, up to date frame, but only the pixels inside the
+         * damage rectangles differ from the previously displayed one. The rectangles never overlap.
+         *
+         * The application guarantees that a plugin receives a full frame through display_game() before the first
+         * call to display_damage(), and again whenever the extent changes.
+         *
+         * The default implementation falls back to display_game(), so a plugin only needs to override this function
+         * if it can take advantage of partial updates.
+         *
          * @param buffer The buffer containing the game's pixel data in ARGB format.
+         * @param extent The dimensions of the buffer.
+         * @param damage The regions of the buffer that changed.
+         */
+        virtual void display_damage(std::vector<ARGB> const &buffer, Extent extent,
+                                    [[maybe_unused]] std::vector<Rect> const &damage) {
+            display_game(buffer, extent);
+        }
+
+        /**
+         * @brief Lend a writable surface to the application, so it can draw the next frame in place.
+         *
+         * This is the zero-copy alternative to display_game() / display_damage(): instead of filling its own buffer
+         * and having the plugin copy it, the application writes the pixels straight into memory owned by the plugin.
+         *
+         * From the application's perspective:
+         * - The application calls acquire_surface() with the extent of the frame it is about to draw.
+         * - If nullptr is returned, the plugin does not support surfaces, and display_game() must be used instead.
+         * - Otherwise the application writes the frame into the surface, honoring its stride and format, and MUST
+         *   call present_surface() afterwards. Only pixels inside the presented damage need to be written, unless
+         *   Surface::preserved is false.
+         *
+         * From the graphical library's perspective (plugin):
+         * - The returned surface must stay valid and must not be read until present_surface() is called.
+         * - Surface::preserved must be false whenever the contents of the last presented frame were lost, e.g. the
+         *   first acquire, a change of extent or a buffer swap.
+         *
+         * The default implementation returns nullptr.
+         *
+         * @param extent The dimensions of the frame the application is about to draw.
+         * @returns A pointer to a surface owned by the plugin, or nullptr if surfaces are not supported.
+         */
+        virtual Surface *acquire_surface([[maybe_unused]] Extent extent) { return nullptr; }
+
+        /**
+         * @brief Hand the surface obtained from acquire_surface() back to the plugin, to be displayed.
+         *
+         * @param damage The regions written since the previous present, empty if nothing changed.
          */
-        virtual void display_game(std::vector<ARGB> const &buffer) = 0;
+        virtual void present_surface([[maybe_unused]] std::vector<Rect> const &damage) {}
     };
 
     // Using extern "C" with namespace is fine, it creates a symbol with the function name.
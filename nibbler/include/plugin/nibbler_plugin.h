@@ -0,0 +1,123 @@
+#pragma once
+
+/*
+ * Plain C plugin ABI, version 2.
+ *
+ * Unlike IPlugin, nothing here depends on a compiler or standard library: only fixed-size integers, plain structs,
+ * and function pointers cross the dlopen() boundary, and frames are passed as pointer + stride buffers.
+ *
+ * A plugin implementing this ABI exports two functions:
+ * - nibbler_plugin_version(), returning NIBBLER_PLUGIN_ABI_VERSION.
+ * - nibbler_plugin_table(), returning a nibbler_plugin_v2 table that stays valid until the plugin is dlclose()d.
+ *
+ * The application checks the version before anything else, falls back to IPlugin's create() / destroy() when the
+ * symbols are missing, and reads the capabilities to pick the fastest way of delivering frames to the plugin.
+ *
+ * The semantics of each function are the ones of the IPlugin method of the same name.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NIBBLER_PLUGIN_ABI_VERSION 2u
+
+/** @brief One pixel, 0xAARRGGBB */
+typedef uint32_t nibbler_argb;
+
+typedef struct nibbler_extent {
+    uint32_t width;
+    uint32_t height;
+} nibbler_extent;
+
+typedef struct nibbler_rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+} nibbler_rect;
+
+/** @brief Not NUL-terminated */
+typedef struct nibbler_string {
+    char const *data;
+    size_t size;
+} nibbler_string;
+
+typedef struct nibbler_menu {
+    nibbler_string name;
+    uint32_t hover_pos;
+    nibbler_string const *options;
+    size_t option_count;
+} nibbler_menu;
+
+/** @brief Pixel formats, the values of interface::PixelFormat */
+enum nibbler_pixel_format { NIBBLER_PIXEL_ARGB8888 = 0 };
+
+/** @brief Capability flags of a plugin */
+enum nibbler_capability {
+    /** @brief display_damage() is implemented, and cheaper than display_game() */
+    NIBBLER_CAP_DAMAGE_RECTS = 1u << 0,
+    /** @brief acquire_surface() / present_surface() are implemented */
+    NIBBLER_CAP_MAPPED_SURFACE = 1u << 1,
+};
+
+typedef struct nibbler_surface {
+    nibbler_argb *pixels;
+    /** @brief In pixels */
+    size_t stride;
+    nibbler_extent extent;
+    /** @brief A nibbler_pixel_format */
+    uint32_t format;
+    /** @brief Non-zero if the surface still holds the last presented frame */
+    uint32_t preserved;
+} nibbler_surface;
+
+/** @brief Called with the user pointer given along with it */
+typedef void (*nibbler_callback)(void *user);
+
+typedef struct nibbler_plugin_v2 {
+    /** @brief NIBBLER_PLUGIN_ABI_VERSION */
+    uint32_t abi_version;
+    /** @brief sizeof(nibbler_plugin_v2), later versions only append fields */
+    uint32_t size;
+    /** @brief nibbler_capability flags */
+    uint32_t capabilities;
+    /** @brief The nibbler_pixel_format the plugin displays without conversion */
+    uint32_t pixel_format;
+    /** @brief See IPlugin::cell_size(), {0, 0} lets the application decide */
+    nibbler_extent cell_size;
+
+    void *(*create)(void);
+    void (*destroy)(void *self);
+
+    /** @brief A NULL callback unregisters input, a value of interface::Input */
+    void (*register_cb)(void *self, uint32_t input, nibbler_callback callback, void *user);
+    /** @brief Blocks for the whole life of the plugin, must call ready(user) before using the callbacks */
+    void (*entrypoint)(void *self, nibbler_callback ready, void *user);
+    /**
+     * @brief Returns immediately, done(user) is called once the plugin can be destroyed. done must be the last plugin
+     * code the calling thread runs: call it from request_shutdown() itself, or from the thread running entrypoint(),
+     * never from a thread of the plugin that keeps running afterwards
+     */
+    void (*request_shutdown)(void *self, nibbler_callback done, void *user);
+
+    void (*display_menu)(void *self, nibbler_menu const *menu);
+    void (*display_game)(void *self, nibbler_argb const *pixels, size_t stride, nibbler_extent extent);
+    /** @brief Only with NIBBLER_CAP_DAMAGE_RECTS */
+    void (*display_damage)(void *self, nibbler_argb const *pixels, size_t stride, nibbler_extent extent,
+                           nibbler_rect const *damage, size_t count);
+    /** @brief Only with NIBBLER_CAP_MAPPED_SURFACE, may return NULL */
+    nibbler_surface *(*acquire_surface)(void *self, nibbler_extent extent);
+    /** @brief Only with NIBBLER_CAP_MAPPED_SURFACE */
+    void (*present_surface)(void *self, nibbler_rect const *damage, size_t count);
+} nibbler_plugin_v2;
+
+uint32_t nibbler_plugin_version(void);
+nibbler_plugin_v2 const *nibbler_plugin_table(void);
+
+#ifdef __cplusplus
+}
+#endif
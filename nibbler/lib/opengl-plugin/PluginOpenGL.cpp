@@ -3,12 +3,128 @@
 #include <GL/freeglut.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <mutex>
+#include <optional>
 #include <sstream>
 
 namespace interface {
     std::unordered_map<interface::Input, interface::Callback> g_callbacks;  // TODO: check
 
+    /**
+     * @brief What is on screen, shared between the application threads, which write frames, and the GLUT thread,
+     * which uploads them to a texture and draws it.
+     */
+    struct Screen {
+        std::mutex mtx;
+        /** @brief Held between acquire_surface() and present_surface() */
+        std::unique_lock<std::mutex> lock{mtx, std::defer_lock};
+        /** @brief The last frame, row-major and tightly packed */
+        std::vector<ARGB> pixels;
+        Extent extent{};
+        Surface surface{};
+        /** @brief Regions of pixels not uploaded to the texture yet */
+        std::vector<Rect> dirty;
+        /** @brief The texture must be (re)allocated and fully uploaded */
+        bool reallocate = true;
+        /** @brief Shown instead of the game when set */
+        std::optional<Menu> menu;
+        GLuint texture = 0;
+        /** @brief Something changed since the last redisplay */
+        std::atomic<bool> posted{false};
+    };
+    static Screen g_screen;
+
+    /**
+     * @brief How often the GLUT thread checks for new frames, a redisplay only happens if there is one. The fast
+     * interval is only kept while frames keep coming, an idle window is polled at the slow one.
+     */
+    static constexpr unsigned int POLL_MS = 4;
+    static constexpr unsigned int IDLE_POLL_MS = 100;
+    /** @brief Fast polls without a new frame before going back to the slow interval */
+    static constexpr unsigned int IDLE_AFTER = IDLE_POLL_MS / POLL_MS;
+
+    /** @brief Make pixels hold extent, with g_screen.mtx held. @returns true if the previous frame was lost. */
+    static bool resize(Extent extent) {
+        if (extent.width == g_screen.extent.width && extent.height == g_screen.extent.height) return false;
+        g_screen.pixels.assign(size_t(extent.width) * extent.height, 0);
+        g_screen.extent = extent;
+        g_screen.reallocate = true;
+        g_screen.dirty.clear();
+        return true;
+    }
+
+    static void copy(std::vector<ARGB> const &buffer, Rect rect) {
+        auto width = g_screen.extent.width;
+        for (auto y = rect.y; y < rect.y + rect.height; ++y) {
+            auto offset = size_t(y) * width + rect.x;
+            std::copy_n(buffer.begin() + offset, rect.width, g_screen.pixels.begin() + offset);
+        }
+    }
+
+    static void post() { g_screen.posted.store(true, std::memory_order_release); }
+
+    /** @brief Stream the dirty regions of the frame into the texture, with g_screen.mtx held. */
+    static void upload() {
+        auto const &[width, height] = g_screen.extent;
+        if (!g_screen.texture) {
+            glGenTextures(1, &g_screen.texture);
+            glBindTexture(GL_TEXTURE_2D, g_screen.texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+        glBindTexture(GL_TEXTURE_2D, g_screen.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, GLint(width));
+        // 0xAARRGGBB words are BGRA in memory, the texture takes them without any conversion
+        if (g_screen.reallocate) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, GLsizei(width), GLsizei(height), 0, GL_BGRA,
+                         GL_UNSIGNED_INT_8_8_8_8_REV, g_screen.pixels.data());
+            g_screen.reallocate = false;
+        } else {
+            for (auto [x, y, w, h] : g_screen.dirty) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, GLint(x), GLint(y), GLsizei(w), GLsizei(h), GL_BGRA,
+                                GL_UNSIGNED_INT_8_8_8_8_REV, g_screen.pixels.data() + size_t(y) * width + x);
+            }
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        g_screen.dirty.clear();
+    }
+
+    static void draw_menu(Menu const &menu) {
+        glColor3f(1, 1, 1);
+        glRasterPos2f(-0.2f, 0.3f);
+        for (auto c : menu.name) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+        for (size_t i = 0; i < menu.options.size(); ++i) {
+            glRasterPos2f(-0.2f, 0.1f - 0.15f * float(i));
+            std::string_view prefix = i == menu.hover_pos ? "> " : "  ";
+            for (auto c : prefix) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+            for (auto c : menu.options[i]) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+        }
+    }
+
+    static void draw_game() {
+        if (!g_screen.extent.width || !g_screen.extent.height) return;
+        upload();
+        glEnable(GL_TEXTURE_2D);
+        glColor3f(1, 1, 1);
+        glBegin(GL_QUADS);  // row 0 of the frame is the top of the window
+        glTexCoord2f(0, 0);
+        glVertex2f(-1, 1);
+        glTexCoord2f(1, 0);
+        glVertex2f(1, 1);
+        glTexCoord2f(1, 1);
+        glVertex2f(1, -1);
+        glTexCoord2f(0, 1);
+        glVertex2f(-1, -1);
+        glEnd();
+        glDisable(GL_TEXTURE_2D);
+    }
+
     std::string PluginOpenGL::greet() { return "Hello from plugin!"; }
     void PluginOpenGL::register_cb(Input input, Callback sig) {
         if (!sig && g_callbacks.contains(input)) {
@@ -23,21 +139,24 @@ namespace interface {
     }
     void display() {
         glClear(GL_COLOR_BUFFER_BIT);
-        glBegin(GL_POLYGON);
-        glVertex3f(0.5, 0.0, 0.5);
-        glVertex3f(0.5, 0.0, 0.0);
-        glVertex3f(0.0, 0.5, 0.0);
-        glVertex3f(0.0, 0.0, 0.5);
-        glEnd();
-        glFlush();
-
-        glClear(GL_COLOR_BUFFER_BIT);
-
+        {
+            std::lock_guard lk(g_screen.mtx);
+            if (g_screen.menu)
+                draw_menu(*g_screen.menu);
+            else
+                draw_game();
+        }
         glutSwapBuffers();
     }
-    void timer([[maybe_unused]] int value) {
-        glutPostRedisplay();
-        glutTimerFunc(100, timer, 0);  // 100 ms timer
+    /** @param idle Number of polls in a row without a new frame */
+    void poll(int idle) {
+        if (g_screen.posted.exchange(false, std::memory_order_acquire)) {
+            glutPostRedisplay();
+            idle = 0;
+        } else if (unsigned(idle) < IDLE_AFTER) {
+            ++idle;
+        }
+        glutTimerFunc(unsigned(idle) < IDLE_AFTER ? POLL_MS : IDLE_POLL_MS, poll, idle);
     }
     void keyHandler(unsigned char key, int, int) {
         switch (key) {
@@ -53,9 +172,51 @@ namespace interface {
             default: SPDLOG_DEBUG("Key number: {}", key);
         }
     }
-    void PluginOpenGL::display_menu(const interface::Menu &) {}
+    void PluginOpenGL::display_menu(const interface::Menu &menu) {
+        std::lock_guard lk(g_screen.mtx);
+        g_screen.menu = menu;
+        post();
+    }
+
+    void PluginOpenGL::display_game(std::vector<ARGB> const &buffer, Extent extent) {
+        std::lock_guard lk(g_screen.mtx);
+        resize(extent);
+        std::copy(buffer.begin(), buffer.end(), g_screen.pixels.begin());
+        g_screen.dirty.assign(1, {.x = 0, .y = 0, .width = extent.width, .height = extent.height});
+        g_screen.menu.reset();
+        post();
+    }
+
+    void PluginOpenGL::display_damage(std::vector<ARGB> const &buffer, Extent extent, std::vector<Rect> const &damage) {
+        std::lock_guard lk(g_screen.mtx);
+        if (resize(extent)) {
+            std::copy(buffer.begin(), buffer.end(), g_screen.pixels.begin());
+        } else {
+            for (auto rect : damage) copy(buffer, rect);
+            g_screen.dirty.insert(g_screen.dirty.end(), damage.begin(), damage.end());
+        }
+        g_screen.menu.reset();
+        post();
+    }
 
-    void PluginOpenGL::display_game(std::vector<ARGB> const &) {}
+    Surface *PluginOpenGL::acquire_surface(Extent extent) {
+        g_screen.lock.lock();
+        bool lost = resize(extent);
+        g_screen.surface = {.pixels = g_screen.pixels.data(),
+                            .stride = extent.width,
+                            .extent = extent,
+                            .format = PixelFormat::ARGB8888,
+                            .preserved = !lost && g_screen.surface.preserved};
+        return &g_screen.surface;
+    }
+
+    void PluginOpenGL::present_surface(std::vector<Rect> const &damage) {
+        if (!g_screen.reallocate) g_screen.dirty.insert(g_screen.dirty.end(), damage.begin(), damage.end());
+        g_screen.surface.preserved = true;
+        g_screen.menu.reset();
+        g_screen.lock.unlock();
+        post();
+    }
 
     static int ac = 1;
     static char const *av[] = {"nibbler", nullptr};
@@ -69,9 +230,14 @@ namespace interface {
         glutDisplayFunc(display);
 
         glutKeyboardFunc(keyHandler);
-        glutTimerFunc(100, timer, 0);
+        glutTimerFunc(POLL_MS, poll, 0);
         glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_CONTINUE_EXECUTION);
-        glEnable(GL_DEPTH_TEST);
+        {
+            std::lock_guard lk(g_screen.mtx);
+            g_screen.texture = 0;  // textures die with their GL context
+            g_screen.reallocate = true;
+        }
+        post();
         future.wait();  // wait for the main process
         glutMainLoop();
         SPDLOG_DEBUG("PluginOpenGL exiting loop...");
@@ -15,6 +15,9 @@ namespace interface {
         void entrypoint(std::future<void> future) override;
         std::future<void> request_shutdown() override;
         void display_menu(Menu const &) override;
-        void display_game(std::vector<ARGB> const &) override;
+        void display_game(std::vector<ARGB> const &, Extent) override;
+        void display_damage(std::vector<ARGB> const &, Extent, std::vector<Rect> const &) override;
+        Surface *acquire_surface(Extent extent) override;
+        void present_surface(std::vector<Rect> const &damage) override;
     };
 }  // namespace interface
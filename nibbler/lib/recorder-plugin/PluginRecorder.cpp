@@ -0,0 +1,328 @@
+#include "PluginRecorder.h"
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace interface {
+    using recording::FileHeader;
+    using recording::FrameKind;
+    using recording::SlotHeader;
+
+    namespace {
+        constexpr size_t SLOT_SIZE = sizeof(SlotHeader) + PluginRecorder::MAX_PIXELS * sizeof(ARGB);
+
+        uint64_t now_ns() {
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        }
+    }  // namespace
+
+    PluginRecorder::~PluginRecorder() {
+        if (_map) munmap(_map, _length);
+        if (_fd != -1) close(_fd);
+    }
+
+    std::string PluginRecorder::greet() { return "Hello from recorder plugin!"; }
+
+    void PluginRecorder::register_cb(Input input, Callback sig) {
+        if (!sig)
+            _callbacks.erase(input);
+        else
+            _callbacks[input] = std::move(sig);
+    }
+
+    void PluginRecorder::entrypoint(std::future<void> future) {
+        SPDLOG_INFO("PluginRecorder starting...");
+        {
+            std::lock_guard lk(_mtx_run);
+            if (_exit) return;  // shut down before it even started
+            _running = true;
+        }
+        future.wait();  // wait for the main process
+        _play_script();
+
+        std::unique_lock lk(_mtx_run);
+        _cv.wait(lk, [this] { return _exit; });
+        _running = false;
+        _done.set_value();
+        SPDLOG_DEBUG("PluginRecorder exiting loop...");
+    }
+
+    void PluginRecorder::_play_script() {
+        auto const *env = std::getenv("NIBBLER_RECORDER_INPUT");
+        if (!env) return;
+
+        std::unique_lock lk(_mtx_run);
+        _cv.wait(lk, [this] { return _shown || _exit; });
+        std::string_view script(env);
+        while (!_exit && !script.empty()) {
+            auto token = script.substr(0, script.find(','));
+            script.remove_prefix(std::min(script.size(), token.size() + 1));
+
+            if (unsigned ms; std::from_chars(token.data(), token.data() + token.size(), ms).ptr == token.end()) {
+                _cv.wait_for(lk, std::chrono::milliseconds(ms), [this] { return _exit; });
+                continue;
+            }
+            auto input = Input::A;
+            while (toString(input) != token && input != Input::ESC) input = static_cast<Input>(uint8_t(input) + 1);
+            if (toString(input) != token) {
+                SPDLOG_WARN("NIBBLER_RECORDER_INPUT: unknown input '{}', skipped", token);
+            } else if (auto it = _callbacks.find(input); it != _callbacks.end()) {
+                SPDLOG_DEBUG("NIBBLER_RECORDER_INPUT: {}", token);
+                it->second();
+            }
+        }
+    }
+
+    std::future<void> PluginRecorder::request_shutdown() {
+        SPDLOG_INFO("PluginRecorder graceful shutdown...");
+        std::lock_guard lk(_mtx_run);
+        _done = {};
+        auto future = _done.get_future();
+        _exit = true;
+        if (_running)
+            _cv.notify_one();
+        else
+            _done.set_value();  // entrypoint() never ran, or already returned
+        return future;
+    }
+
+    void PluginRecorder::display_menu(Menu const &menu) {
+        std::string text;
+        for (size_t i = 0; i < menu.options.size(); ++i) {
+            text += i == menu.hover_pos ? "> " : "  ";
+            text += menu.options[i];
+            text += '\n';
+        }
+
+        if (std::lock_guard lk(_mtx); _open()) {
+            auto size = static_cast<uint32_t>(std::min(text.size(), MAX_PIXELS * sizeof(ARGB)));
+            auto &slot = _begin(FrameKind::MENU, {}, size);
+            std::memcpy(_payload(slot), text.data(), size);
+            _commit(slot);
+        }
+        _show();  // even when not recording, the script must run for the application to exit
+    }
+
+    void PluginRecorder::display_game(std::vector<ARGB> const &buffer, Extent extent) {
+        record_game(buffer.data(), extent.width, extent);
+    }
+
+    void PluginRecorder::record_game(ARGB const *pixels, size_t stride, Extent extent) {
+        if (std::lock_guard lk(_mtx); _open() && size_t(extent.width) * extent.height <= MAX_PIXELS) {
+            auto count = size_t(extent.width) * extent.height;
+            auto &slot = _begin(FrameKind::GAME, extent, static_cast<uint32_t>(count * sizeof(ARGB)));
+            auto *out = reinterpret_cast<ARGB *>(_payload(slot));
+            for (uint32_t y = 0; y < extent.height; ++y) {
+                std::memcpy(out + size_t(y) * extent.width, pixels + y * stride, extent.width * sizeof(ARGB));
+            }
+            _commit(slot);
+        }
+        _show();
+    }
+
+    Surface *PluginRecorder::acquire_surface(Extent extent) {
+        auto pixels = size_t(extent.width) * extent.height;
+        _lock.lock();
+        if (!_open() || pixels > MAX_PIXELS) {
+            _lock.unlock();
+            return nullptr;
+        }
+        _slot = &_begin(FrameKind::GAME, extent, static_cast<uint32_t>(pixels * sizeof(ARGB)));
+        // Every slot holds a different, older frame: the application must draw the whole frame each time
+        _surface = {.pixels = reinterpret_cast<ARGB *>(_payload(*_slot)),
+                    .stride = extent.width,
+                    .extent = extent,
+                    .format = PixelFormat::ARGB8888,
+                    .preserved = false};
+        return &_surface;
+    }
+
+    void PluginRecorder::present_surface(std::vector<Rect> const &) {
+        _commit(*_slot);
+        _slot = nullptr;
+        _lock.unlock();
+        _show();
+    }
+
+    void PluginRecorder::_show() {
+        std::lock_guard lk(_mtx_run);
+        if (!_shown) {
+            _shown = true;
+            _cv.notify_all();
+        }
+    }
+
+    bool PluginRecorder::_open() {
+        if (_map) return true;
+        if (_failed) return false;  // already logged, do not retry on every frame
+
+        auto const *env = std::getenv("NIBBLER_RECORDER_PATH");
+        auto const *path = env ? env : DEFAULT_PATH;
+        _length = sizeof(FileHeader) + SLOT_COUNT * SLOT_SIZE;
+
+        auto fail = [this, path](char const *what) {
+            SPDLOG_ERROR("Cannot {} {}: {}, not recording", what, path, std::strerror(errno));
+            if (_fd != -1) close(_fd);
+            _fd = -1;
+            _failed = true;
+            return false;
+        };
+        _fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (_fd == -1 || ftruncate(_fd, static_cast<off_t>(_length)) == -1) return fail("create");
+        auto *map = mmap(nullptr, _length, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (map == MAP_FAILED) return fail("map");
+        _map = static_cast<std::byte *>(map);
+
+        // The file was truncated, so every slot reads as zeroes: a sequence number of 0 and no frame
+        auto *header = new (_map) FileHeader{.magic = {},
+                                             .version = recording::VERSION,
+                                             .slot_count = SLOT_COUNT,
+                                             .slot_size = SLOT_SIZE,
+                                             .head = 0};
+        for (uint32_t i = 0; i < SLOT_COUNT; ++i) new (_map + sizeof(FileHeader) + i * SLOT_SIZE) SlotHeader{};
+        std::memcpy(header->magic, recording::MAGIC, sizeof(recording::MAGIC));
+        SPDLOG_INFO("Recording frames into {} ({} slots of {} bytes)", path, SLOT_COUNT, SLOT_SIZE);
+        return true;
+    }
+
+    SlotHeader &PluginRecorder::_begin(FrameKind kind, Extent extent, uint32_t size) {
+        ++_frame;
+        auto &slot = *reinterpret_cast<SlotHeader *>(_map + sizeof(FileHeader) + (_frame % SLOT_COUNT) * SLOT_SIZE);
+        slot.seq.store(2 * _frame - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // readers must see the odd seq before any new byte
+        slot.kind = kind;
+        slot.extent = extent;
+        slot.size = size;
+        return slot;
+    }
+
+    void PluginRecorder::_commit(SlotHeader &slot) {
+        slot.timestamp_ns = now_ns();
+        slot.seq.store(2 * _frame, std::memory_order_release);
+        reinterpret_cast<FileHeader *>(_map)->head.store(_frame, std::memory_order_release);
+    }
+
+    std::byte *PluginRecorder::_payload(SlotHeader &slot) { return reinterpret_cast<std::byte *>(&slot + 1); }
+
+    namespace {
+        /**
+         * @brief An instance for the C ABI: the plugin, its surface in the C layout, and the pending done callback of
+         * request_shutdown().
+         *
+         * No thread of our own ever calls done: it is called by request_shutdown() itself when the entrypoint is not
+         * running, or else by the entrypoint thread as the very last thing before leaving the plugin. Once done is
+         * called, the host may destroy() and dlclose() the plugin right away.
+         */
+        struct RecorderC {
+            PluginRecorder plugin;
+            nibbler_surface surface{};
+
+            std::mutex mtx;
+            bool running = false;
+            nibbler_callback done = nullptr;
+            void *done_user = nullptr;
+        };
+
+        RecorderC &self(void *p) { return *static_cast<RecorderC *>(p); }
+
+        nibbler_plugin_v2 const TABLE{
+            .abi_version = NIBBLER_PLUGIN_ABI_VERSION,
+            .size = sizeof(nibbler_plugin_v2),
+            .capabilities = NIBBLER_CAP_MAPPED_SURFACE,
+            .pixel_format = NIBBLER_PIXEL_ARGB8888,
+            .cell_size = {.width = 0, .height = 0},
+            .create = []() -> void * { return new RecorderC; },
+            .destroy = [](void *p) { delete &self(p); },
+            .register_cb =
+                [](void *p, uint32_t input, nibbler_callback callback, void *user) {
+                    Callback cb;
+                    if (callback) cb = [callback, user] { callback(user); };
+                    self(p).plugin.register_cb(static_cast<Input>(input), std::move(cb));
+                },
+            .entrypoint =
+                [](void *p, nibbler_callback ready, void *user) {
+                    auto &recorder = self(p);
+                    {
+                        std::lock_guard lk(recorder.mtx);
+                        recorder.running = true;
+                    }
+                    std::promise<void> promise;
+                    promise.set_value();
+                    ready(user);
+                    recorder.plugin.entrypoint(promise.get_future());
+
+                    nibbler_callback done;
+                    void *done_user;
+                    {
+                        std::lock_guard lk(recorder.mtx);
+                        recorder.running = false;
+                        done = std::exchange(recorder.done, nullptr);
+                        done_user = recorder.done_user;
+                    }
+                    if (done) done(done_user);
+                },
+            .request_shutdown =
+                [](void *p, nibbler_callback done, void *user) {
+                    auto &recorder = self(p);
+                    bool running;
+                    {
+                        std::lock_guard lk(recorder.mtx);
+                        running = recorder.running;
+                        if (running) {
+                            recorder.done = done;
+                            recorder.done_user = user;
+                        }
+                    }
+                    auto future = recorder.plugin.request_shutdown();
+                    if (!running) {
+                        future.wait();
+                        done(user);
+                    }
+                },
+            .display_menu =
+                [](void *p, nibbler_menu const *menu) {
+                    std::vector<std::string_view> options;
+                    for (size_t i = 0; i < menu->option_count; ++i) {
+                        options.emplace_back(menu->options[i].data, menu->options[i].size);
+                    }
+                    self(p).plugin.display_menu({.name = {menu->name.data, menu->name.size},
+                                                 .hover_pos = static_cast<unsigned short>(menu->hover_pos),
+                                                 .options = std::move(options)});
+                },
+            .display_game =
+                [](void *p, nibbler_argb const *pixels, size_t stride, nibbler_extent extent) {
+                    self(p).plugin.record_game(pixels, stride, {.width = extent.width, .height = extent.height});
+                },
+            .display_damage = nullptr,
+            .acquire_surface = [](void *p, nibbler_extent extent) -> nibbler_surface * {
+                auto &recorder = self(p);
+                auto *surface = recorder.plugin.acquire_surface({.width = extent.width, .height = extent.height});
+                if (!surface) return nullptr;
+                recorder.surface = {.pixels = surface->pixels,
+                                    .stride = surface->stride,
+                                    .extent = extent,
+                                    .format = NIBBLER_PIXEL_ARGB8888,
+                                    .preserved = surface->preserved};
+                return &recorder.surface;
+            },
+            .present_surface = [](void *p, nibbler_rect const *, size_t) { self(p).plugin.present_surface({}); },
+        };
+    }  // namespace
+
+    extern "C" {
+    IPlugin *create() { return new PluginRecorder; }
+    void destroy(IPlugin *p) { delete p; }
+    uint32_t nibbler_plugin_version() { return NIBBLER_PLUGIN_ABI_VERSION; }
+    nibbler_plugin_v2 const *nibbler_plugin_table() { return &TABLE; }
+    }
+}  // namespace interface
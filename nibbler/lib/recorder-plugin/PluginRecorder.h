@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Recording.h"
+#include "game/Menu.h"
+#include "plugin/IPlugin.h"
+#include "plugin/nibbler_plugin.h"
+
+namespace interface {
+    /**
+     * @brief Headless plugin writing every frame into a memory-mapped ring file (see Recording.h).
+     *
+     * External tools map the same file to read the frames, without any copy and without ever blocking the game. The
+     * file is NIBBLER_RECORDER_PATH, or DEFAULT_PATH when unset. Game frames are drawn straight into the ring through
+     * acquire_surface() / present_surface().
+     *
+     * Being headless, the plugin has no keyboard: NIBBLER_RECORDER_INPUT can script the input instead, as a comma
+     * separated list of interface::Input names, fired in order once the first menu or frame is displayed, and of
+     * numbers, waiting that many milliseconds. E.g. "ENTER,ENTER,5000,ESC" starts a game, lets it run for 5 seconds,
+     * and exits.
+     *
+     * Both the C++ interface and the plain C ABI (see nibbler_plugin.h) are exported, the latter being preferred by
+     * the application.
+     */
+    class PluginRecorder : public interface::IPlugin {
+       public:
+        static constexpr uint32_t SLOT_COUNT = 8;
+        /** @brief Largest frame a slot can hold, bigger frames are dropped */
+        static constexpr size_t MAX_PIXELS = 1024 * 768;
+        static constexpr char const *DEFAULT_PATH = "/dev/shm/nibbler.rec";
+
+        PluginRecorder() = default;
+        ~PluginRecorder() override;
+
+        std::string greet() override;
+        void register_cb(Input input, Callback sig) override;
+        void entrypoint(std::future<void> future) override;
+        std::future<void> request_shutdown() override;
+        void display_menu(Menu const &menu) override;
+        void display_game(std::vector<ARGB> const &buffer, Extent extent) override;
+        /** @brief Same as display_game(), from rows of stride pixels. */
+        void record_game(ARGB const *pixels, size_t stride, Extent extent);
+        Surface *acquire_surface(Extent extent) override;
+        void present_surface(std::vector<Rect> const &damage) override;
+
+       private:
+        /** @brief Fire the NIBBLER_RECORDER_INPUT script, if any, once something is displayed or until shut down. */
+        void _play_script();
+        /** @brief Something was displayed: the application is running, start the script. */
+        void _show();
+        /** @brief Create and map the ring file if not done yet, with _mtx held. @returns false on failure. */
+        bool _open();
+        /** @brief Start writing the next frame, with _mtx held. @returns Its slot, sequence lock taken. */
+        recording::SlotHeader &_begin(recording::FrameKind kind, Extent extent, uint32_t size);
+        /** @brief Publish the frame started by _begin(). */
+        void _commit(recording::SlotHeader &slot);
+        std::byte *_payload(recording::SlotHeader &slot);
+
+        std::mutex _mtx;
+        /** @brief Held between acquire_surface() and present_surface() */
+        std::unique_lock<std::mutex> _lock{_mtx, std::defer_lock};
+        int _fd = -1;
+        std::byte *_map = nullptr;
+        /** @brief _open() failed once, and is not tried again */
+        bool _failed = false;
+        size_t _length = 0;
+        /** @brief Number of the last frame started */
+        uint64_t _frame = 0;
+        recording::SlotHeader *_slot = nullptr;
+        Surface _surface{};
+
+        std::unordered_map<Input, Callback> _callbacks;
+
+        std::mutex _mtx_run;
+        std::condition_variable _cv;
+        bool _running = false;
+        bool _exit = false;
+        /** @brief A menu or a game frame was displayed, the script can start */
+        bool _shown = false;
+        std::promise<void> _done;
+    };
+}  // namespace interface
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "plugin/IPlugin.h"
+
+/**
+ * @brief Layout of the ring file written by PluginRecorder, for the tools reading it.
+ *
+ * The file starts with a FileHeader, followed by FileHeader::slot_count slots of FileHeader::slot_size bytes. Each
+ * slot is a SlotHeader followed by its payload: the ARGB pixels of a game frame, row-major and tightly packed, or the
+ * text of a menu, one option per line and the hovered one prefixed with "> ".
+ *
+ * Frame n (starting at 1) is written into slot n % slot_count. The writer never waits for readers, each slot is
+ * guarded by a sequence lock instead:
+ * - While frame n is being written, SlotHeader::seq is 2n - 1. Once complete it is 2n, and FileHeader::head is n.
+ * - A reader loads head, then the seq of its slot, copies what it needs and loads seq again. The copy is valid if
+ *   both loads returned 2 * head. Otherwise the writer lapped the reader, which should retry with the new head.
+ */
+namespace interface::recording {
+    constexpr char MAGIC[8] = {'N', 'I', 'B', 'B', 'L', 'E', 'R', 'R'};
+    constexpr uint32_t VERSION = 1;
+
+    enum class FrameKind : uint32_t { GAME, MENU };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the sequence numbers are shared between processes");
+
+    struct alignas(64) FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t slot_count;
+        /** @brief Bytes between two consecutive slots, SlotHeader included */
+        uint64_t slot_size;
+        /** @brief Number of the last complete frame, 0 if none */
+        std::atomic<uint64_t> head;
+    };
+
+    struct alignas(64) SlotHeader {
+        /** @brief Sequence lock, odd while the slot is being written */
+        std::atomic<uint64_t> seq;
+        /** @brief CLOCK_MONOTONIC time at which the frame was completed, in nanoseconds */
+        uint64_t timestamp_ns;
+        FrameKind kind;
+        /** @brief Dimensions of a GAME frame, {0, 0} for a MENU */
+        Extent extent;
+        /** @brief Bytes of payload */
+        uint32_t size;
+    };
+}  // namespace interface::recording
@@ -0,0 +1,267 @@
+#include "PluginTerminal.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace interface {
+    namespace {
+        constexpr std::string_view ENTER_SCREEN = "\x1b[?1049h\x1b[?25l";  // alternate screen, hidden cursor
+        constexpr std::string_view LEAVE_SCREEN = "\x1b[0m\x1b[?25h\x1b[?1049l";
+        constexpr std::string_view CLEAR = "\x1b[0m\x1b[2J\x1b[H";
+
+        void write_all(int fd, std::string_view out) {
+            while (!out.empty()) {
+                auto n = write(fd, out.data(), out.size());
+                if (n <= 0) return;
+                out.remove_prefix(n);
+            }
+        }
+    }  // namespace
+
+    std::string PluginTerminal::greet() { return "Hello from terminal plugin!"; }
+
+    void PluginTerminal::register_cb(Input input, Callback sig) {
+        if (!sig)
+            _callbacks.erase(input);
+        else
+            _callbacks[input] = std::move(sig);
+    }
+
+    void PluginTerminal::entrypoint(std::future<void> future) {
+        SPDLOG_INFO("PluginTerminal starting...");
+        {
+            std::lock_guard lk(_mtx_run);
+            if (_exit) return;  // shut down before it even started
+            _running = true;
+        }
+        future.wait();  // wait for the main process
+
+        _tty = open("/dev/tty", O_RDWR | O_CLOEXEC);
+        int fd = _tty != -1 ? _tty : STDIN_FILENO;
+        bool raw = tcgetattr(fd, &_saved) == 0;
+        if (raw) {
+            auto t = _saved;
+            t.c_lflag &= ~(ICANON | ECHO);
+            t.c_iflag &= ~ICRNL;
+            t.c_cc[VMIN] = 0;
+            t.c_cc[VTIME] = 0;
+            tcsetattr(fd, TCSANOW, &t);
+        }
+        write_all(_tty != -1 ? _tty : STDOUT_FILENO, ENTER_SCREEN);
+
+        auto deadline = std::chrono::steady_clock::now();
+        while (!_exit) {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            pollfd p{.fd = _keys ? fd : -1, .events = POLLIN, .revents = 0};
+            if (poll(&p, 1, static_cast<int>(std::max<int64_t>(0, left.count()))) > 0) _read_keys();
+            if (!_keys_pending.empty() && std::chrono::steady_clock::now() - _keys_since >= ESCAPE_TIMEOUT) {
+                _parse_keys(true);  // nothing completed the sequence, it was the Escape key
+            }
+
+            if (auto now = std::chrono::steady_clock::now(); now >= deadline) {
+                _refresh();
+                deadline = std::max(deadline + REFRESH_PERIOD, now);
+            }
+        }
+
+        write_all(_tty != -1 ? _tty : STDOUT_FILENO, LEAVE_SCREEN);
+        if (raw) tcsetattr(fd, TCSANOW, &_saved);
+        if (_tty != -1) close(_tty);
+        _tty = -1;
+
+        std::lock_guard lk(_mtx_run);
+        _running = false;
+        _done.set_value();
+        SPDLOG_DEBUG("PluginTerminal exiting loop...");
+    }
+
+    std::future<void> PluginTerminal::request_shutdown() {
+        SPDLOG_INFO("PluginTerminal graceful shutdown...");
+        std::lock_guard lk(_mtx_run);
+        _done = {};
+        auto future = _done.get_future();
+        _exit = true;
+        if (!_running) _done.set_value();  // entrypoint() never ran, or already returned
+        return future;
+    }
+
+    void PluginTerminal::display_menu(Menu const &menu) {
+        std::lock_guard lk(_mtx);
+        _menu = menu;
+        _posted = true;
+    }
+
+    void PluginTerminal::display_game(std::vector<ARGB> const &buffer, Extent extent) {
+        std::lock_guard lk(_mtx);
+        _frame.assign(buffer.begin(), buffer.end());
+        _extent = extent;
+        _full = true;
+        _damage.clear();
+        _menu.reset();
+        _posted = true;
+    }
+
+    void PluginTerminal::display_damage(std::vector<ARGB> const &buffer, Extent extent,
+                                        std::vector<Rect> const &damage) {
+        {
+            std::lock_guard lk(_mtx);
+            if (extent.width == _extent.width && extent.height == _extent.height && _frame.size() == buffer.size()) {
+                for (auto [x, y, width, height] : damage) {
+                    for (auto row = y; row < y + height; ++row) {
+                        auto offset = size_t(row) * extent.width + x;
+                        std::copy_n(buffer.begin() + offset, width, _frame.begin() + offset);
+                    }
+                }
+                if (_damage.size() + damage.size() > MAX_DAMAGE_RECTS) _full = true;
+                if (!_full) _damage.insert(_damage.end(), damage.begin(), damage.end());
+                _menu.reset();
+                _posted = true;
+                return;
+            }
+        }
+        display_game(buffer, extent);  // nothing to apply the damage to
+    }
+
+    Extent PluginTerminal::cell_size() { return {1, 1}; }
+
+    void PluginTerminal::_read_keys() {
+        char buf[64];
+        auto n = read(_tty != -1 ? _tty : STDIN_FILENO, buf, sizeof(buf));
+        if (n <= 0) {
+            _keys = n < 0;  // end of input, stop polling it
+            _parse_keys(true);
+            return;
+        }
+        if (_keys_pending.empty()) _keys_since = std::chrono::steady_clock::now();
+        _keys_pending.append(buf, static_cast<size_t>(n));
+        _parse_keys(false);
+    }
+
+    void PluginTerminal::_parse_keys(bool flush) {
+        auto const &buf = _keys_pending;
+        auto const n = buf.size();
+        size_t i = 0;
+        for (; i < n; ++i) {
+            switch (buf[i]) {
+                case '\x1b':
+                    if (!flush && (i + 1 == n || (i + 2 == n && buf[i + 1] == '['))) {
+                        // The rest of the sequence may still be on its way
+                        _keys_since = std::chrono::steady_clock::now();
+                        _keys_pending.erase(0, i);
+                        return;
+                    }
+                    if (i + 2 < n && buf[i + 1] == '[') {  // arrow keys
+                        switch (buf[i + 2]) {
+                            case 'A': _press(Input::W); break;
+                            case 'B': _press(Input::S); break;
+                            case 'C': _press(Input::D); break;
+                            case 'D': _press(Input::A); break;
+                            default: SPDLOG_DEBUG("Escape sequence: {}", buf[i + 2]);
+                        }
+                        i += 2;
+                    } else {
+                        _press(Input::ESC);
+                        if (i + 1 < n && buf[i + 1] == '[') ++i;  // flushed before the sequence completed
+                    }
+                    break;
+                case '\r': [[fallthrough]];
+                case '\n': _press(Input::ENTER); break;
+                case '1': _press(Input::ONE); break;
+                case '2': _press(Input::TWO); break;
+                case '3': _press(Input::THREE); break;
+                case 'a': _press(Input::A); break;
+                case 's': _press(Input::S); break;
+                case 'd': _press(Input::D); break;
+                case 'w': _press(Input::W); break;
+                default: SPDLOG_DEBUG("Key number: {}", static_cast<int>(buf[i]));
+            }
+        }
+        _keys_pending.clear();
+    }
+
+    void PluginTerminal::_press(Input input) {
+        if (auto it = _callbacks.find(input); it != _callbacks.end()) it->second();
+    }
+
+    void PluginTerminal::_refresh() {
+        int fd = _tty != -1 ? _tty : STDOUT_FILENO;
+        winsize ws{};
+        Extent terminal = ioctl(fd, TIOCGWINSZ, &ws) == 0 ? Extent{.width = ws.ws_col / 2u, .height = ws.ws_row}
+                                                          : Extent{.width = 40, .height = 24};
+        bool resized = terminal.width != _terminal.width || terminal.height != _terminal.height;
+        {
+            std::lock_guard lk(_mtx);
+            if (!_posted && !resized) return;
+            _posted = false;
+            _out.clear();
+            if (resized) {
+                _terminal = terminal;
+                _shown_extent = {};  // the screen content is unknown, redraw everything
+            }
+            if (_menu)
+                _draw_menu(*_menu);
+            else
+                _draw_game(terminal);
+        }
+        write_all(fd, _out);
+    }
+
+    void PluginTerminal::_draw_game(Extent terminal) {
+        auto const [width, height] = _extent;
+        bool full = width != _shown_extent.width || height != _shown_extent.height;
+        if (full) {
+            _shown.assign(_frame.size(), 0);
+            _shown_extent = _extent;
+            _out += CLEAR;
+        }
+        // Only the damaged regions can differ from the screen, unless it has to be redrawn
+        if (full || _full) _damage.assign(1, {.x = 0, .y = 0, .width = width, .height = height});
+
+        auto out = std::back_inserter(_out);
+        // Where the cursor is, and its colour, so that cursor moves and colour changes are only sent when needed
+        uint32_t cursor_x = UINT32_MAX, cursor_y = UINT32_MAX;
+        std::optional<ARGB> colour;
+        for (auto rect : _damage) {
+            for (uint32_t y = rect.y; y < std::min(rect.y + rect.height, terminal.height); ++y) {
+                for (uint32_t x = rect.x; x < std::min(rect.x + rect.width, terminal.width); ++x) {
+                    auto c = _frame[size_t(y) * width + x];
+                    auto &shown = _shown[size_t(y) * width + x];
+                    if (!full && c == shown) continue;
+                    shown = c;
+                    if (x != cursor_x || y != cursor_y) fmt::format_to(out, "\x1b[{};{}H", y + 1, 2 * x + 1);
+                    if (c != colour) {
+                        fmt::format_to(out, "\x1b[48;2;{};{};{}m", (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+                    }
+                    _out += "  ";
+                    cursor_x = x + 1;
+                    cursor_y = y;
+                    colour = c;
+                }
+            }
+        }
+        if (colour) _out += "\x1b[0m";
+        _damage.clear();
+        _full = false;
+    }
+
+    void PluginTerminal::_draw_menu(Menu const &menu) {
+        _shown_extent = {};  // the game is cleared from the screen
+        auto out = std::back_inserter(_out);
+        _out += CLEAR;
+        fmt::format_to(out, "{}\r\n\r\n", menu.name);
+        for (size_t i = 0; i < menu.options.size(); ++i) {
+            fmt::format_to(out, "{}{}\r\n", i == menu.hover_pos ? "> " : "  ", menu.options[i]);
+        }
+    }
+
+    extern "C" {
+    IPlugin *create() { return new PluginTerminal; }
+    void destroy(IPlugin *p) { delete p; }
+    }
+}  // namespace interface
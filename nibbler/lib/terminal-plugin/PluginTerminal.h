@@ -0,0 +1,84 @@
+#pragma once
+
+#include <termios.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "game/Menu.h"
+#include "plugin/IPlugin.h"
+
+namespace interface {
+    /**
+     * @brief Plugin drawing the game in an ANSI terminal, one cell as two coloured spaces.
+     *
+     * Frames are only stored when received, and display_damage() only copies the damaged regions. At most
+     * REFRESH_RATE times per second, the regions damaged since the last refresh are compared with the frame on screen,
+     * and only the cells that differ are sent: a cursor move when they are not contiguous, a colour change when needed,
+     * and the cell itself. The whole update goes out in a single write().
+     *
+     * Keys are read, in raw mode, by the same thread. Both go through /dev/tty when available, so the logs can be
+     * redirected away from the game. An escape sequence split across two reads is kept until it completes, a lone ESC
+     * is only taken as the Escape key once nothing followed it for ESCAPE_TIMEOUT.
+     */
+    class PluginTerminal : public interface::IPlugin {
+       public:
+        static constexpr unsigned int REFRESH_RATE = 60;
+        static constexpr auto REFRESH_PERIOD = std::chrono::microseconds(1'000'000 / REFRESH_RATE);
+        static constexpr auto ESCAPE_TIMEOUT = std::chrono::milliseconds(50);
+        /** @brief Past this number of damaged regions pending, the next refresh compares the whole frame */
+        static constexpr size_t MAX_DAMAGE_RECTS = 64;
+
+        std::string greet() override;
+        void register_cb(Input input, Callback sig) override;
+        void entrypoint(std::future<void> future) override;
+        std::future<void> request_shutdown() override;
+        void display_menu(Menu const &menu) override;
+        void display_game(std::vector<ARGB> const &buffer, Extent extent) override;
+        void display_damage(std::vector<ARGB> const &buffer, Extent extent, std::vector<Rect> const &damage) override;
+        Extent cell_size() override;
+
+       private:
+        void _read_keys();
+        /** @brief Press the keys of _keys_pending, keeping an incomplete escape sequence unless flush is set. */
+        void _parse_keys(bool flush);
+        void _press(Input input);
+        /** @brief Send what changed since the last refresh, if anything. */
+        void _refresh();
+        void _draw_game(Extent terminal);
+        void _draw_menu(Menu const &menu);
+
+        std::mutex _mtx;
+        std::vector<ARGB> _frame;
+        Extent _extent{};
+        std::optional<Menu> _menu;
+        bool _posted = false;
+        /** @brief Regions of _frame changed since the last refresh, ignored when _full is set */
+        std::vector<Rect> _damage;
+        bool _full = false;
+
+        /** @brief Owned by the refresh thread */
+        std::vector<ARGB> _shown;
+        Extent _shown_extent{};
+        Extent _terminal{};
+        std::string _out;
+
+        std::unordered_map<Input, Callback> _callbacks;
+        /** @brief Bytes read but not parsed yet: the start of an escape sequence */
+        std::string _keys_pending;
+        std::chrono::steady_clock::time_point _keys_since;
+        int _tty = -1;
+        bool _keys = true;
+        termios _saved{};
+
+        std::mutex _mtx_run;
+        bool _running = false;
+        std::atomic<bool> _exit = false;
+        std::promise<void> _done;
+    };
+}  // namespace interface
@@ -1,34 +1,43 @@
-#if SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_TRACE
-// https://github.com/gabime/spdlog/wiki/3.-Custom-formatting
-#define PATTERN "[%^%l%$]\t[%t] [%!] %v"
-#else
-#define PATTERN "[%^%l%$] %v"
-#endif
-
 #include "App.h"
 
+#include <cstdio>
+#include <cstdlib>
+
+#include "game/log/Log.h"
 #include "game/snake/Snake.h"
 #include "game/state/impl/ExitState.h"
 #include "literals.h"
 
 namespace game {
     App::App(int ac, char const *av[]) : _args(av, av + ac) {
-        spdlog::set_level(spdlog::level::trace);
-        spdlog::flush_on(spdlog::level::trace);
-        spdlog::set_pattern(PATTERN);
+        log::init();
         SPDLOG_DEBUG("Args: {}", fmt::join(_args, " ."));
     }
 
     void App::init() {
-        _worker = std::make_unique<worker::Worker>(2);
-        _event_queue = std::make_unique<state::EventQueue>();
-        _plugin_switcher = std::make_unique<plugin::PluginSwitcher>(std::span{++_args.begin(), _args.end()});
         _conf = std::make_unique<config::Config>();
+        _plugin_switcher = std::make_unique<plugin::PluginSwitcher>(std::span{++_args.begin(), _args.end()});
 
         // TODO improve
         _conf->game_height = 20;
         _conf->game_width = 20;
-        _context = std::make_unique<state::Context>(*_conf);
+        if (auto const *size = std::getenv("NIBBLER_BOARD_SIZE"); size) {
+            // WIDTHxHEIGHT, e.g. 10000x10000
+            size_t width = 0, height = 0;
+            if (std::sscanf(size, "%zux%zu", &width, &height) != 2 || width < literals::BOARD_MINIMUM_WIDTH ||
+                height < literals::BOARD_MINIMUM_HEIGHT || width > literals::BOARD_MAXIMUM_CELLS / height) {
+                SPDLOG_ERROR("NIBBLER_BOARD_SIZE={}: expected WIDTHxHEIGHT, from {}x{} to {} cells. Using {}x{}", size,
+                             literals::BOARD_MINIMUM_WIDTH, literals::BOARD_MINIMUM_HEIGHT,
+                             literals::BOARD_MAXIMUM_CELLS, _conf->game_width, _conf->game_height);
+            } else {
+                _conf->game_width = width;
+                _conf->game_height = height;
+            }
+        }
+        if (auto const *path = std::getenv("NIBBLER_REPLAY_PATH"); path) _conf->replay_path = path;
+        _conf->autopilot = std::getenv("NIBBLER_AUTOPILOT") != nullptr;
+        _conf->warm_plugins = std::getenv("NIBBLER_WARM_PLUGINS") != nullptr;
+        _context = std::make_unique<state::Context>(*_conf, *_plugin_switcher);
         _context->subscribe<state::impl::ExitState>([this] {
             auto &[exit, cv, _] = this->_lmao_exit;
             exit = true;
@@ -36,8 +45,7 @@ namespace game {
         });
 
         // TODO: Use an Adapter design pattern to convert from Event to Domain specific Event...
-        _event_queue->subscribe([this](state::Event event) { _plugin_switcher->handle_event(event); });
-        _event_queue->subscribe([this](state::Event event) { _context->handle_event(event); });
+        _event_queue = std::make_unique<state::EventQueue<EventRouter>>(EventRouter(*_plugin_switcher, *_context));
 
         _plugin_switcher->register_setup([this](interface::IPlugin &plugin) {
             SPDLOG_DEBUG("Setting up Plugin...");
@@ -48,17 +56,24 @@ namespace game {
             }).detach();
 
             using interface::Input;
-            plugin.register_cb(Input::ENTER, [this] { _event_queue->push(state::Event::ENTER); });
-            plugin.register_cb(Input::ESC, [this] { _event_queue->push(state::Event::EXIT); });
-            plugin.register_cb(Input::A, [this] { _event_queue->push(state::Event::LEFT); });
-            plugin.register_cb(Input::S, [this] { _event_queue->push(state::Event::DOWN); });
-            plugin.register_cb(Input::D, [this] { _event_queue->push(state::Event::RIGHT); });
-            plugin.register_cb(Input::W, [this] { _event_queue->push(state::Event::UP); });
-            plugin.register_cb(Input::ONE, [this] { _event_queue->push(state::Event::PLUGIN_1); });
-            plugin.register_cb(Input::TWO, [this] { _event_queue->push(state::Event::PLUGIN_1); });
-            plugin.register_cb(Input::THREE, [this] { _event_queue->push(state::Event::PLUGIN_3); });
+            // Resident plugins keep running in the background, only the active one may send input
+            auto bind = [this, &plugin](Input input, state::Event event) {
+                plugin.register_cb(input, [this, &plugin, event] {
+                    if (_plugin_switcher->active(plugin)) _event_queue->push(event);
+                });
+            };
+            bind(Input::ENTER, state::Event::ENTER);
+            bind(Input::ESC, state::Event::EXIT);
+            bind(Input::A, state::Event::LEFT);
+            bind(Input::S, state::Event::DOWN);
+            bind(Input::D, state::Event::RIGHT);
+            bind(Input::W, state::Event::UP);
+            bind(Input::ONE, state::Event::PLUGIN_1);
+            bind(Input::TWO, state::Event::PLUGIN_2);
+            bind(Input::THREE, state::Event::PLUGIN_3);
             promise.set_value();
         });
+        if (_conf->warm_plugins) _plugin_switcher->warm_up();
         _plugin_switcher->switch_plugin("1");
 
         auto snake = snake::Snake(20, 20);
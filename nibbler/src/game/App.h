@@ -3,10 +3,12 @@
 #include "game/plugin/Plugin.h"
 #include "game/state/Context.h"
 #include "game/state/Event.h"
-#include "game/worker/Worker.h"
+#include "game/state/EventRouter.h"
 
 namespace game {
     class App {
+        using EventRouter = state::EventRouter<plugin::PluginSwitcher, state::Context>;
+
        public:
         App() = delete;
         App(App &&) = delete;
@@ -19,10 +21,10 @@ namespace game {
        private:
         std::vector<std::string_view> _args{};
         std::tuple<std::atomic<bool>, std::condition_variable, std::mutex> _lmao_exit;
+        // Destroyed in reverse order: the EventQueue first, as its notifier calls into the Context and PluginSwitcher.
+        std::unique_ptr<config::Config> _conf;
         std::unique_ptr<plugin::PluginSwitcher> _plugin_switcher;
-        std::unique_ptr<state::EventQueue> _event_queue;
         std::unique_ptr<state::Context> _context;
-        std::unique_ptr<worker::Worker> _worker;
-        std::unique_ptr<config::Config> _conf;
+        std::unique_ptr<state::EventQueue<EventRouter>> _event_queue;
     };
 }  // namespace game
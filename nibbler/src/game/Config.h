@@ -1,12 +1,45 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
+
+#include "game/timing/TickScheduler.h"
+
 namespace game::config {
     struct Config {
         size_t game_width;
         size_t game_height;
-        size_t game_speed_ms = 1000;
+        /**
+         * @brief Resolution the board is upscaled to, in pixels. Every cell is a block of whole pixels: display_width
+         * divided by the cells in view wide, and display_height divided by the cells in view tall, e.g. 40x30 for 20x20
+         */
+        uint32_t display_width = 800;
+        uint32_t display_height = 600;
+        /**
+         * @brief Cells displayed around the Player, 0 for the whole board. Never more than one cell per pixel of the
+         * display, so the window is always smaller than the display on huge boards
+         */
+        uint32_t view_width = 0;
+        uint32_t view_height = 0;
+        /** @brief Time between two ticks, 0 runs the game as fast as possible */
+        std::chrono::nanoseconds game_tick = std::chrono::seconds(1);
+        /** @brief What to do when the game falls behind its tick rate */
+        timing::TickPolicy tick_policy = timing::TickPolicy::SKIP;
+        /** @brief Busy-wait this long before each tick, for accurate sub-millisecond tick rates */
+        std::chrono::nanoseconds tick_spin = std::chrono::nanoseconds::zero();
+        /**
+         * @brief Load and start every plugin once, so that switching plugin is instant. Opt-in: every plugin then runs
+         * from the start, holding its terminal or window even while another one is active.
+         */
+        bool warm_plugins = false;
+        /** @brief Record every game to this file (see engine::ReplayWriter), empty to disable */
+        std::string replay_path;
+        /** @brief Let engine::Autopilot play, skipping the main menu, unless the board has too many cells for it */
+        bool autopilot = false;
+        /** @brief Time the Autopilot may spend deciding a move, 0 for no limit */
+        std::chrono::nanoseconds autopilot_budget = std::chrono::microseconds(500);
         std::vector<std::string> plugin_paths;
     };
 }  // namespace game::config
\ No newline at end of file
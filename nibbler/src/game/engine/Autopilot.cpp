@@ -0,0 +1,202 @@
+#include "Autopilot.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "game/engine/exception.h"
+#include "literals.h"
+
+namespace game::engine {
+    using snake::Entity;
+
+    namespace {
+        /** @return The number of cells of the board, once checked against the cap */
+        size_t checked_cells(size_t width, size_t height) {
+            if (height && width > literals::AUTOPILOT_MAXIMUM_CELLS / height) {
+                throw exception::AutopilotBoardSizeException();
+            }
+            return width * height;
+        }
+    }  // namespace
+
+    Autopilot::Autopilot(size_t width, size_t height, std::chrono::nanoseconds budget)
+        : _width(width),
+          _budget(budget),
+          _queue(checked_cells(width, height)),
+          _parent(_queue.size()),
+          _distance(_queue.size()),
+          _visited(_queue.size(), 0),
+          _occupied(_queue.size(), 0) {}
+
+    Orientation Autopilot::operator()(Engine const &engine) {
+        auto const &snake = engine.snake();
+        auto [x, y] = snake._player.head();
+        auto head = static_cast<uint32_t>(x + y * _width);
+        _deadline = _budget.count() ? timing::Clock::now() + _budget : timing::Clock::time_point::max();
+        ++_stats.moves;
+
+        auto search = _to_food(snake, head);
+        if (search == Search::FOUND) {
+            ++_stats.paths;
+        } else if (search == Search::UNREACHABLE) {
+            search = _detour(snake, head);
+            ++_stats.detours;
+        }
+        if (search == Search::EXPIRED) {
+            ++_stats.overruns;
+            _move = _greedy(snake, head);
+        }
+        // Trapped, any direction is as bad as the previous one
+        if (_move != NONE) _last = _towards(head, _move);
+        return _last;
+    }
+
+    Autopilot::Stats const &Autopilot::stats() const { return _stats; }
+
+    template <class Blocked>
+    Autopilot::Search Autopilot::_bfs(uint32_t from, uint32_t to, Blocked &&blocked) {
+        auto visit = _next(_visit, _visited);
+        size_t first = 0;
+        size_t last = 0;
+        _queue[last++] = from;
+        _visited[from] = visit;
+        _parent[from] = NONE;
+        _distance[from] = 0;
+
+        for (uint32_t expanded = 1; first < last; ++expanded) {
+            if (expanded % CHECK_EVERY == 0 && _expired()) return Search::EXPIRED;
+            auto cell = _queue[first++];
+            for (auto next : _neighbours(cell)) {
+                if (_visited[next] == visit || (next != to && blocked(next))) continue;
+                _visited[next] = visit;
+                _parent[next] = cell;
+                _distance[next] = _distance[cell] + 1;
+                if (next == to) return Search::FOUND;
+                _queue[last++] = next;
+            }
+        }
+        return Search::UNREACHABLE;
+    }
+
+    Autopilot::Search Autopilot::_to_food(snake::Snake const &snake, uint32_t head) {
+        _move = NONE;
+        auto food = snake._board.food();
+        auto search = _bfs(head, food, [&](uint32_t cell) { return !_free(snake, cell); });
+        if (search != Search::FOUND) return search;
+
+        // The body once the food is eaten: the path, then the current body, one cell longer than now
+        auto const &body = snake._player.body();
+        auto body_mark = _next(_body, _occupied);
+        auto length = body.size() + 1;
+        size_t count = 0;
+        auto tail = head;
+        auto occupy = [&](uint32_t cell) {
+            if (count == length) return;
+            _occupied[cell] = body_mark;
+            tail = cell;
+            ++count;
+        };
+        auto move = food;
+        for (auto cell = _parent[food]; cell != NONE; cell = _parent[cell]) {
+            occupy(cell);
+            if (_parent[cell] == head) move = cell;
+        }
+        for (size_t i = 0; i < body.size() && count < length; ++i) occupy(body[i]);
+
+        search = _bfs(food, tail, [&](uint32_t cell) { return _wall(snake, cell) || _occupied[cell] == body_mark; });
+        if (search != Search::FOUND) return search;
+        if (_distance[tail] < MIN_TAIL_DISTANCE) return Search::UNREACHABLE;
+        _move = move;
+        return search;
+    }
+
+    Autopilot::Search Autopilot::_detour(snake::Snake const &snake, uint32_t head) {
+        _move = NONE;
+        auto const &body = snake._player.body();
+        uint32_t longest = 0;
+
+        for (auto next : _neighbours(head)) {
+            if (!_free(snake, next)) continue;
+            // The body after this move, one cell longer if it eats
+            auto body_mark = _next(_body, _occupied);
+            auto length = body.size() + (next == snake._board.food() ? 1 : 0);
+            _occupied[head] = body_mark;
+            auto tail = head;
+            for (size_t i = 0; i + 1 < length; ++i) {
+                tail = body[i];
+                _occupied[tail] = body_mark;
+            }
+
+            auto search = _bfs(next, tail, [&](uint32_t cell) {
+                return _wall(snake, cell) || _occupied[cell] == body_mark;
+            });
+            if (search == Search::EXPIRED) return search;
+            if (search == Search::FOUND && _distance[tail] >= MIN_TAIL_DISTANCE && _distance[tail] > longest) {
+                longest = _distance[tail];
+                _move = next;
+            }
+        }
+        if (_move != NONE) return Search::FOUND;
+
+        // No way back to the tail, make the most of the room left
+        size_t room = 0;
+        for (auto next : _neighbours(head)) {
+            if (!_free(snake, next)) continue;
+            if (_expired()) return Search::EXPIRED;
+            if (auto reachable = snake._board.occupancy().reachable(next % _width, next / _width); reachable > room) {
+                room = reachable;
+                _move = next;
+            }
+        }
+        return _move != NONE ? Search::FOUND : Search::UNREACHABLE;
+    }
+
+    uint32_t Autopilot::_greedy(snake::Snake const &snake, uint32_t head) const {
+        auto food = snake._board.food();
+        auto distance = [this, food](uint32_t cell) {
+            auto dx = static_cast<int64_t>(cell % _width) - static_cast<int64_t>(food % _width);
+            auto dy = static_cast<int64_t>(cell / _width) - static_cast<int64_t>(food / _width);
+            return std::abs(dx) + std::abs(dy);
+        };
+        auto best = NONE;
+        auto closest = std::numeric_limits<int64_t>::max();
+        for (auto next : _neighbours(head)) {
+            if (_free(snake, next) && distance(next) < closest) {
+                closest = distance(next);
+                best = next;
+            }
+        }
+        return best;
+    }
+
+    bool Autopilot::_wall(snake::Snake const &snake, uint32_t cell) const {
+        return snake._board.matrix()[cell] == Entity::Wall;
+    }
+
+    bool Autopilot::_free(snake::Snake const &snake, uint32_t cell) const {
+        return !snake::blocks(snake._board.matrix()[cell]);
+    }
+
+    std::array<uint32_t, 4> Autopilot::_neighbours(uint32_t cell) const {
+        // The border is all walls, and walls are never expanded: the neighbours are always on the board
+        auto width = static_cast<uint32_t>(_width);
+        return {cell - width, cell + width, cell + 1, cell - 1};
+    }
+
+    Orientation Autopilot::_towards(uint32_t from, uint32_t to) const {
+        if (to + _width == from) return Orientation::NORTH;
+        if (to == from + _width) return Orientation::SOUTH;
+        return to > from ? Orientation::EAST : Orientation::WEST;
+    }
+
+    bool Autopilot::_expired() const { return timing::Clock::now() > _deadline; }
+
+    uint32_t Autopilot::_next(uint32_t &generation, std::vector<uint32_t> &stamps) {
+        if (++generation == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+        return generation;
+    }
+}  // namespace game::engine
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "game/engine/Engine.h"
+#include "game/timing/TickScheduler.h"
+
+namespace game::engine {
+    /**
+     * @brief Plays a game on its own, an Engine::run() controller.
+     *
+     * Each tick, a breadth-first search looks for the shortest path to the food. The path is only taken if, once the
+     * snake has eaten, its tail is still reachable from its head: the snake can then always follow its own tail and
+     * never traps itself. Otherwise the autopilot chases its tail the long way round, until a safe path opens up.
+     *
+     * Every search buffer is allocated once, for the whole board, and reused: a tick never allocates. When the
+     * searches take longer than the budget, they are abandoned and the greedy move towards the food is played.
+     */
+    class Autopilot {
+       public:
+        struct Stats {
+            /** @brief Moves decided */
+            uint64_t moves = 0;
+            /** @brief Moves following a safe path to the food */
+            uint64_t paths = 0;
+            /** @brief Moves chasing the tail, or making room, because no safe path was found */
+            uint64_t detours = 0;
+            /** @brief Moves played greedily because the budget ran out */
+            uint64_t overruns = 0;
+        };
+
+        /**
+         * @brief Autopilot constructor.
+         * @param width Board width of the games to play.
+         * @param height Board height of the games to play.
+         * @param budget Time allowed to decide a move, 0 for no limit.
+         * @throws exception::AutopilotBoardSizeException above literals::AUTOPILOT_MAXIMUM_CELLS, before allocating.
+         */
+        Autopilot(size_t width, size_t height, std::chrono::nanoseconds budget = std::chrono::nanoseconds::zero());
+
+        /** @return The next direction of the Player. */
+        Orientation operator()(Engine const &engine);
+
+        [[nodiscard]] Stats const &stats() const;
+
+       private:
+        enum class Search { FOUND, UNREACHABLE, EXPIRED };
+
+        /** @brief Breadth-first search from a cell, up to a target cell (reached even if blocked) */
+        template <class Blocked>
+        Search _bfs(uint32_t from, uint32_t to, Blocked &&blocked);
+        /** @brief Follow the shortest path to the food, if it is safe */
+        Search _to_food(snake::Snake const &snake, uint32_t head);
+        /** @brief The free neighbour the tail is the furthest from, or the one with the most reachable cells */
+        Search _detour(snake::Snake const &snake, uint32_t head);
+        /** @brief The free neighbour closest to the food, without any search */
+        uint32_t _greedy(snake::Snake const &snake, uint32_t head) const;
+
+        [[nodiscard]] bool _wall(snake::Snake const &snake, uint32_t cell) const;
+        [[nodiscard]] bool _free(snake::Snake const &snake, uint32_t cell) const;
+        [[nodiscard]] std::array<uint32_t, 4> _neighbours(uint32_t cell) const;
+        [[nodiscard]] Orientation _towards(uint32_t from, uint32_t to) const;
+        [[nodiscard]] bool _expired() const;
+        /** @brief Start a new generation of stamps, instead of clearing the buffers */
+        uint32_t _next(uint32_t &generation, std::vector<uint32_t> &stamps);
+
+        static constexpr uint32_t NONE = UINT32_MAX;
+        /** @brief The tail only leaves its cell after the head moved: the head must never be right behind it */
+        static constexpr uint32_t MIN_TAIL_DISTANCE = 2;
+        /** @brief Nodes expanded between two clock reads */
+        static constexpr uint32_t CHECK_EVERY = 256;
+
+        size_t _width;
+        std::chrono::nanoseconds _budget;
+        timing::Clock::time_point _deadline;
+        /** @brief The neighbour of the head picked by the last search, or NONE */
+        uint32_t _move = NONE;
+        Orientation _last = Orientation::SOUTH;
+        Stats _stats;
+
+        /** @brief The search frontier */
+        std::vector<uint32_t> _queue;
+        /** @brief The cell each visited cell was reached from, and its distance to the start */
+        std::vector<uint32_t> _parent;
+        std::vector<uint32_t> _distance;
+        /** @brief Cells visited by the current search, when stamped with _visit */
+        std::vector<uint32_t> _visited;
+        uint32_t _visit = 0;
+        /** @brief Cells of the simulated body, when stamped with _body */
+        std::vector<uint32_t> _occupied;
+        uint32_t _body = 0;
+    };
+}  // namespace game::engine
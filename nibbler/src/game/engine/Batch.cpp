@@ -0,0 +1,39 @@
+#include "Batch.h"
+
+#include <stdexcept>
+
+namespace game::engine {
+    Batch::Batch(size_t count, size_t width, size_t height, snake::Seed seed, worker::Worker &pool)
+        : _count(count),
+          _width(width),
+          _height(height),
+          _pool(pool),
+          _games(std::make_unique<std::optional<Engine>[]>(count)),
+          _outcomes(count, Outcome::MOVED) {
+        for (size_t i = 0; i < count; ++i) {
+            _games[i].emplace(width, height, seed + i);
+        }
+    }
+
+    std::span<Outcome const> Batch::step(std::span<Orientation const> actions) {
+        if (actions.size() != _count) throw std::invalid_argument("Batch::step() needs one action per game");
+        _pool.parallel_for(
+            0, _count,
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    _outcomes[i] = _games[i]->step(actions[i]);
+                }
+            },
+            GRAIN);
+        return _outcomes;
+    }
+
+    void Batch::reset(size_t i, snake::Seed seed) {
+        _games[i].emplace(_width, _height, seed);
+        _outcomes[i] = Outcome::MOVED;
+    }
+
+    Engine const &Batch::operator[](size_t i) const { return *_games[i]; }
+
+    size_t Batch::size() const { return _count; }
+}  // namespace game::engine
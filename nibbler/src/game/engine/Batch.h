@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "game/engine/Engine.h"
+#include "game/worker/Worker.h"
+
+namespace game::engine {
+    /**
+     * @brief Steps many independent Snake games at once, spreading them across cores.
+     *
+     * The games are split into contiguous slices, each stepped as a single task of a shared worker::Worker pool, so a
+     * thread only ever touches its own games during a step(). The calling thread works on the first slice.
+     *
+     * The layout is not cache-friendly beyond that: only the Engine objects are stored side by side, each game still
+     * allocates its own board (Matrix tiles, occupancy Bitboard, Player body) on the heap.
+     */
+    class Batch {
+       public:
+        /**
+         * @brief Batch constructor.
+         * @param count Number of games.
+         * @param width Board width of every game.
+         * @param height Board height of every game.
+         * @param seed Seed of the first game, the i-th game is seeded with seed + i.
+         * @param pool The pool stepping the games.
+         */
+        Batch(size_t count, size_t width, size_t height, snake::Seed seed, worker::Worker &pool);
+
+        Batch(Batch const &) = delete;
+        Batch(Batch &&) = delete;
+
+        /**
+         * @brief Advance every game by exactly one tick.
+         *
+         * Games already over are left untouched and report their final Outcome again.
+         *
+         * @param actions One direction per game.
+         * @returns One Outcome per game, valid until the next step().
+         * @throws std::invalid_argument if actions.size() is not size(), before any game is stepped.
+         */
+        std::span<Outcome const> step(std::span<Orientation const> actions);
+
+        /**
+         * @brief Start the i-th game over.
+         * @param i Index of the game.
+         * @param seed Seed of the new game.
+         */
+        void reset(size_t i, snake::Seed seed);
+
+        [[nodiscard]] Engine const &operator[](size_t i) const;
+        [[nodiscard]] size_t size() const;
+
+       private:
+        /** @brief Below this number of games per slice, the synchronization costs more than the stepping */
+        static constexpr size_t GRAIN = 64;
+
+        size_t _count;
+        size_t _width;
+        size_t _height;
+        worker::Worker &_pool;
+        std::unique_ptr<std::optional<Engine>[]> _games;
+        std::vector<Outcome> _outcomes;
+    };
+}  // namespace game::engine
@@ -0,0 +1,51 @@
+#include "Engine.h"
+
+namespace game::engine {
+    Engine::Engine(size_t width, size_t height, snake::Seed seed) : _seed(seed), _snake(width, height, seed) {}
+
+    Outcome Engine::step(Orientation o) {
+        if (over()) return _last;
+        _last = _snake._player.step(o);
+        ++_ticks;
+        if (_history) _history->snapshot();
+        return _last;
+    }
+
+    void Engine::keep_history(size_t depth) { _history = std::make_unique<snake::History>(_snake, depth, _ticks); }
+
+    void Engine::rewind(uint64_t tick) {
+        if (!_history) throw snake::exception::HistoryRangeException();
+        _history->rewind(tick);
+        // Only the last tick of a game is over, and it is never rewound to
+        if (tick != _ticks) _last = Outcome::MOVED;
+        _ticks = tick;
+    }
+
+    bool Engine::over() const { return _last == Outcome::DIED || _last == Outcome::WON; }
+
+    uint64_t Engine::ticks() const { return _ticks; }
+
+    Outcome Engine::last() const { return _last; }
+
+    snake::Seed Engine::seed() const { return _seed; }
+
+    uint64_t Engine::hash() const {
+        uint64_t h = 0xCBF29CE484222325;
+        auto const &m = _snake._board.matrix();
+        for (size_t y = 0; y < m.height; ++y) {
+            for (size_t x = 0; x < m.width;) {
+                auto cells = m.segment(x, y);
+                for (auto e : cells) {
+                    h ^= static_cast<uint8_t>(e);
+                    h *= 0x100000001B3;
+                }
+                x += cells.size();
+            }
+        }
+        return h;
+    }
+
+    snake::Snake &Engine::snake() { return _snake; }
+
+    snake::Snake const &Engine::snake() const { return _snake; }
+}  // namespace game::engine
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "game/snake/History.h"
+#include "game/snake/Snake.h"
+
+namespace game::engine {
+    using snake::Orientation;
+    using snake::Outcome;
+
+    /**
+     * @brief Headless, deterministic stepping of a single Snake game.
+     *
+     * The Engine knows nothing about time, plugins or events: each step() advances the game by exactly one tick,
+     * as fast as the caller asks for it. Nothing on the step() path sleeps, logs or performs I/O. Given the same seed
+     * and the same inputs, two Engines always play the same game.
+     */
+    class Engine {
+       public:
+        /**
+         * @brief Engine constructor.
+         * @param width Board width.
+         * @param height Board height.
+         * @param seed Seed of the food placement.
+         */
+        Engine(size_t width, size_t height, snake::Seed seed = snake::random_seed());
+
+        /** @brief Not copyable nor movable: the snake::History, if any, refers to the Snake of this Engine. */
+        Engine(Engine const &) = delete;
+        Engine(Engine &&) = delete;
+
+        /**
+         * @brief Advance the game by exactly one tick.
+         *
+         * Once the game is over (DIED or WON), the board is left untouched and the final Outcome is returned again.
+         *
+         * @param o Direction to move the Player to.
+         * @returns The Outcome of the tick.
+         */
+        Outcome step(Orientation o);
+
+        /**
+         * @brief Step uncapped, as fast as the CPU allows, until the game is over or max_ticks elapsed.
+         * @tparam Controller Callable with signature Orientation(Engine const &), asked for a direction every tick.
+         * @param controller The direction provider.
+         * @param max_ticks Upper bound of ticks to perform.
+         * @returns The number of ticks performed.
+         */
+        template <class Controller>
+        uint64_t run(Controller &&controller, uint64_t max_ticks);
+
+        /**
+         * @brief Snapshot every following tick into a snake::History, starting with the current one.
+         * @param depth Number of ticks that can be rewound.
+         */
+        void keep_history(size_t depth);
+
+        /**
+         * @brief Go back to a recent tick, see snake::History::rewind(). The game is playable again from there.
+         * @throws snake::exception::HistoryRangeException if the tick is not held, or if there is no history.
+         */
+        void rewind(uint64_t tick);
+
+        /** @return true once the Player died or won. */
+        [[nodiscard]] bool over() const;
+        /** @return The number of ticks performed since construction. */
+        [[nodiscard]] uint64_t ticks() const;
+        /** @return The Outcome of the last tick. */
+        [[nodiscard]] Outcome last() const;
+        /** @return The Seed the game was created with. */
+        [[nodiscard]] snake::Seed seed() const;
+        /** @return A digest of the board (FNV-1a over the cells), to compare two games. */
+        [[nodiscard]] uint64_t hash() const;
+        [[nodiscard]] snake::Snake &snake();
+        [[nodiscard]] snake::Snake const &snake() const;
+
+       private:
+        snake::Seed _seed;
+        snake::Snake _snake;
+        uint64_t _ticks = 0;
+        Outcome _last = Outcome::MOVED;
+        std::unique_ptr<snake::History> _history;
+    };
+
+    template <class Controller>
+    uint64_t Engine::run(Controller &&controller, uint64_t max_ticks) {
+        uint64_t n = 0;
+        for (; n < max_ticks && !over(); ++n) {
+            step(controller(static_cast<Engine const &>(*this)));
+        }
+        return n;
+    }
+}  // namespace game::engine
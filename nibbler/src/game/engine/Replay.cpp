@@ -0,0 +1,108 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "game/engine/exception.h"
+#include "literals.h"
+
+namespace game::engine {
+    ReplayWriter::ReplayWriter(std::string const &path, Engine const &engine)
+        : _out(path, std::ios::binary | std::ios::trunc) {
+        if (!_out) throw exception::ReplayIOException();
+        auto const &board = engine.snake()._board;
+        ReplayHeader header{.magic = {},
+                            .version = ReplayHeader::VERSION,
+                            .width = static_cast<uint32_t>(board.width()),
+                            .height = static_cast<uint32_t>(board.height()),
+                            .reserved = 0,
+                            .seed = engine.seed()};
+        std::copy(std::begin(ReplayHeader::MAGIC), std::end(ReplayHeader::MAGIC), header.magic);
+        _out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    }
+
+    void ReplayWriter::turn(uint64_t tick, Orientation orientation, uint64_t timestamp_ns) {
+        _write({.tick = static_cast<uint32_t>(tick),
+                .kind = ReplayRecord::Kind::TURN,
+                .value = static_cast<uint8_t>(orientation),
+                .reserved = 0,
+                .payload = timestamp_ns});
+    }
+
+    void ReplayWriter::end(Engine const &engine) {
+        _write({.tick = static_cast<uint32_t>(engine.ticks()),
+                .kind = ReplayRecord::Kind::END,
+                .value = static_cast<uint8_t>(engine.last()),
+                .reserved = 0,
+                .payload = engine.hash()});
+        _out.flush();
+    }
+
+    void ReplayWriter::_write(ReplayRecord const &record) {
+        _out.write(reinterpret_cast<char const *>(&record), sizeof(record));
+    }
+
+    Replay Replay::load(std::string const &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw exception::ReplayIOException();
+
+        Replay replay{};
+        if (!in.read(reinterpret_cast<char *>(&replay.header), sizeof(replay.header)) ||
+            !std::equal(std::begin(ReplayHeader::MAGIC), std::end(ReplayHeader::MAGIC), replay.header.magic) ||
+            replay.header.version != ReplayHeader::VERSION) {
+            throw exception::ReplayFormatException();
+        }
+        ReplayRecord record{};
+        while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) replay.records.push_back(record);
+        if (in.gcount() != 0) throw exception::ReplayFormatException();  // truncated record
+        replay.validate();
+        return replay;
+    }
+
+    void Replay::validate() const {
+        auto const width = size_t(header.width), height = size_t(header.height);
+        if (width < literals::BOARD_MINIMUM_WIDTH || height < literals::BOARD_MINIMUM_HEIGHT ||
+            width * height > literals::BOARD_MAXIMUM_CELLS) {
+            throw exception::ReplayFormatException();
+        }
+
+        uint32_t tick = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            auto const &record = records[i];
+            bool valid = record.tick >= tick;
+            switch (record.kind) {
+                case ReplayRecord::Kind::TURN: valid = valid && record.value <= uint8_t(Orientation::WEST); break;
+                case ReplayRecord::Kind::END:
+                    valid = valid && record.value <= uint8_t(Outcome::WON) && i + 1 == records.size();
+                    break;
+                default: valid = false;
+            }
+            if (!valid) throw exception::ReplayFormatException();
+            tick = record.tick;
+        }
+        if (records.empty() || records.back().kind != ReplayRecord::Kind::END) {
+            throw exception::ReplayFormatException();
+        }
+    }
+
+    ReplayResult play(Replay const &replay) {
+        replay.validate();
+        Engine engine(replay.header.width, replay.header.height, replay.header.seed);
+        auto orientation = Orientation::NORTH;
+        std::optional<ReplayRecord> end;
+
+        for (auto const &record : replay.records) {
+            engine.run([&orientation](Engine const &) { return orientation; }, record.tick - engine.ticks());
+            if (record.kind == ReplayRecord::Kind::END) {
+                end = record;
+                break;
+            }
+            orientation = static_cast<Orientation>(record.value);
+        }
+
+        ReplayResult result{.ticks = engine.ticks(), .outcome = engine.last(), .hash = engine.hash(), .matches = false};
+        result.matches = end && end->tick == result.ticks && end->value == static_cast<uint8_t>(result.outcome) &&
+                         end->payload == result.hash;
+        return result;
+    }
+}  // namespace game::engine
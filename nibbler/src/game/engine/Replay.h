@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "game/engine/Engine.h"
+
+namespace game::engine {
+    /**
+     * @brief Binary replay log of a game: what is needed to play it again, tick for tick.
+     *
+     * A ReplayHeader, followed by 16-byte ReplayRecords in tick order: a TURN whenever the Player is given a
+     * direction, then a single END holding the final state. Little-endian, as written by the machine.
+     */
+    struct ReplayHeader {
+        static constexpr char MAGIC[8] = {'N', 'I', 'B', 'R', 'E', 'P', 'L', 'Y'};
+        static constexpr uint32_t VERSION = 2;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t reserved;
+        snake::Seed seed;
+    };
+    static_assert(sizeof(ReplayHeader) == 32);
+
+    struct ReplayRecord {
+        enum class Kind : uint8_t { TURN, END };
+
+        /** @brief The tick the record applies to: a TURN is used by that tick's step() */
+        uint32_t tick;
+        Kind kind;
+        /** @brief The Orientation of a TURN, the Outcome of the END */
+        uint8_t value;
+        uint16_t reserved;
+        /** @brief Input timestamp of a TURN since the game started (ns), board hash of the END */
+        uint64_t payload;
+    };
+    static_assert(sizeof(ReplayRecord) == 16);
+
+    /** @brief Appends a game to a replay file, while it is being played. Writes are buffered. */
+    class ReplayWriter {
+       public:
+        ReplayWriter(std::string const &path, Engine const &engine);
+
+        void turn(uint64_t tick, Orientation orientation, uint64_t timestamp_ns);
+        /** @brief Record the final state, and flush. */
+        void end(Engine const &engine);
+
+       private:
+        void _write(ReplayRecord const &record);
+
+        std::ofstream _out;
+    };
+
+    struct Replay {
+        ReplayHeader header;
+        std::vector<ReplayRecord> records;
+
+        /** @throws exception::ReplayIOException, exception::ReplayFormatException, see validate() */
+        static Replay load(std::string const &path);
+
+        /**
+         * @brief Check that the Replay can be played: a board size the game accepts, records in tick order with a
+         * valid Kind and value, and a single END, last.
+         * @throws exception::ReplayFormatException otherwise.
+         */
+        void validate() const;
+    };
+
+    struct ReplayResult {
+        uint64_t ticks;
+        Outcome outcome;
+        uint64_t hash;
+        /** @brief The game ended in the recorded state */
+        bool matches;
+    };
+
+    /**
+     * @brief Play a Replay again, headless and as fast as possible, and compare the final state with the recorded
+     * one.
+     * @throws exception::ReplayFormatException if the Replay is not valid, see Replay::validate().
+     */
+    ReplayResult play(Replay const &replay);
+}  // namespace game::engine
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <exception>
+
+namespace game::engine::exception {
+    struct AutopilotBoardSizeException : public std::exception {
+        [[nodiscard]] const char *what() const noexcept final { return "The board is too large for the autopilot!"; }
+    };
+
+    struct ReplayIOException : public std::exception {
+        [[nodiscard]] const char *what() const noexcept final { return "Cannot read or write the replay file!"; }
+    };
+
+    struct ReplayFormatException : public std::exception {
+        [[nodiscard]] const char *what() const noexcept final {
+            return "Not a replay file, an unsupported version, or a corrupted replay";
+        }
+    };
+}  // namespace game::engine::exception
@@ -0,0 +1,78 @@
+#if SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_TRACE
+// https://github.com/gabime/spdlog/wiki/3.-Custom-formatting
+#define PATTERN "[%^%l%$]\t[%t] [%!] %v"
+#else
+#define PATTERN "[%^%l%$] %v"
+#endif
+
+#include "Log.h"
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include "game/state/Event.h"
+
+namespace game::log {
+    namespace {
+        constexpr size_t QUEUE_SIZE = 8192;
+    }
+
+    void init() {
+        spdlog::init_thread_pool(QUEUE_SIZE, 1);
+        auto logger = spdlog::create_async_nb<spdlog::sinks::stdout_color_sink_mt>("nibbler");
+        spdlog::set_default_logger(std::move(logger));
+        spdlog::set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
+        spdlog::flush_on(spdlog::level::warn);
+        spdlog::set_pattern(PATTERN);
+    }
+
+    void shutdown() {
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+        Tracer::instance().stop();  // otherwise there is no probe, and no Tracer to stop
+#endif
+        spdlog::shutdown();
+    }
+
+    Tracer &Tracer::instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    Tracer::Tracer() : _epoch(timing::Clock::now()), _writer([this](std::stop_token token) { _write(token); }) {}
+
+    void Tracer::record(Probe probe, uint64_t a, uint64_t b, uint64_t c) {
+        if (!_queue.push({.timestamp = timing::Clock::now(), .probe = probe, .args = {a, b, c}})) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Tracer::stop() {
+        if (_writer.joinable()) {
+            _writer.request_stop();
+            _writer.join();
+        }
+    }
+
+    void Tracer::_write(std::stop_token const &token) {
+        while (!token.stop_requested()) {
+            _drain();
+            std::this_thread::sleep_for(PERIOD);
+        }
+        _drain();
+    }
+
+    void Tracer::_drain() {
+        while (auto record = _queue.pop()) {
+            auto since = std::chrono::duration_cast<std::chrono::microseconds>(record->timestamp - _epoch);
+            auto const &[a, b, c] = record->args;
+            auto const fmt = fmt::runtime(format(record->probe));
+            auto message = record->probe == Probe::EVENT
+                               ? fmt::format(fmt, state::toString(static_cast<state::Event>(a)))
+                               : fmt::format(fmt, a, b, c);
+            spdlog::debug("[+{}us] {}", since.count(), message);
+        }
+        if (auto dropped = _dropped.exchange(0, std::memory_order_relaxed); dropped) {
+            spdlog::warn("Tracer full, {} records dropped!", dropped);
+        }
+    }
+}  // namespace game::log
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+#include "game/state/MpscQueue.h"
+#include "game/timing/TickScheduler.h"
+
+namespace game::log {
+    /**
+     * @brief Installs an asynchronous default logger: call sites only enqueue the message, a single writer thread owns
+     * the sinks. When the queue is full the oldest message is overwritten, so logging never blocks a hot path.
+     */
+    void init();
+
+    /**
+     * @brief Drains the Tracer, when probes are compiled in, and the async logger. Must be the last thing to log.
+     */
+    void shutdown();
+
+    /**
+     * @brief Hot path events, recorded in binary form and only formatted by the Tracer writer thread.
+     *
+     * LATENESS and INPUT_LATENCY carry every sample of the timing::Histograms summarized when a game ends, so that
+     * any percentile can be computed from a trace.
+     */
+    enum class Probe : uint8_t { EVENT, TICK, TURN_DROPPED, LATENESS, INPUT_LATENCY };
+
+    constexpr std::string_view format(Probe probe) {
+        switch (probe) {
+            case Probe::EVENT: return "Dispatching Event {}";
+            case Probe::TICK: return "Tick {}, outcome {}";
+            case Probe::TURN_DROPPED: return "Turn buffer full, turn {} ignored";
+            case Probe::LATENESS: return "Tick started {}ns after its deadline";
+            case Probe::INPUT_LATENCY: return "Tick {} displayed {}ns after its input";
+        }
+        return "Unknown probe";
+    }
+
+    struct Record {
+        timing::Clock::time_point timestamp;
+        Probe probe;
+        std::array<uint64_t, 3> args;
+    };
+
+    /**
+     * @brief Binary trace ring for hot paths.
+     *
+     * record() costs a timestamp and a lock-free push, no formatting nor allocation. A writer thread wakes up every
+     * PERIOD, formats the pending Records and hands them to spdlog at debug level. Records are dropped, and counted,
+     * when the ring is full.
+     */
+    class Tracer {
+       public:
+        static constexpr size_t CAPACITY = 4096;
+        static constexpr auto PERIOD = std::chrono::milliseconds(10);
+
+        static Tracer &instance();
+
+        void record(Probe probe, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0);
+        void stop();
+
+       private:
+        Tracer();
+
+        void _write(std::stop_token const &token);
+        void _drain();
+
+        timing::Clock::time_point const _epoch;
+        std::atomic<size_t> _dropped{0};
+        state::MpscQueue<Record, CAPACITY> _queue;
+        std::jthread _writer;  // must be the last
+    };
+}  // namespace game::log
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define NIBBLER_PROBE(probe, ...) ::game::log::Tracer::instance().record(probe, __VA_ARGS__)
+#else
+#define NIBBLER_PROBE(probe, ...) (void)0
+#endif
@@ -0,0 +1,121 @@
+#include "CPlugin.h"
+
+#include <spdlog/spdlog.h>
+
+#include "exception.h"
+
+namespace game::plugin {
+    namespace {
+        nibbler_extent convert(interface::Extent extent) { return {.width = extent.width, .height = extent.height}; }
+
+        nibbler_string convert(std::string_view str) { return {.data = str.data(), .size = str.size()}; }
+    }  // namespace
+
+    CPlugin::CPlugin(nibbler_plugin_v2 const &table, uint32_t capabilities)
+        : _table(table), _capabilities(capabilities), _self(table.create()) {
+        if (!_self) throw exception::PluginInstanceException();
+        if (_table.pixel_format != NIBBLER_PIXEL_ARGB8888) {
+            SPDLOG_WARN("Unsupported pixel format {}, using ARGB8888", _table.pixel_format);
+        }
+        SPDLOG_INFO("C ABI v{} plugin, frames through {}", _table.abi_version,
+                    _capabilities & NIBBLER_CAP_MAPPED_SURFACE ? "mapped surface"
+                    : _capabilities & NIBBLER_CAP_DAMAGE_RECTS ? "damage rectangles"
+                                                               : "full frames");
+    }
+
+    CPlugin::~CPlugin() { _table.destroy(_self); }
+
+    std::string CPlugin::greet() { return "Hello from C plugin!"; }
+
+    void CPlugin::register_cb(interface::Input input, interface::Callback callback) {
+        auto code = static_cast<uint32_t>(input);
+        if (!callback) {
+            _table.register_cb(_self, code, nullptr, nullptr);
+            _callbacks.erase(input);
+            return;
+        }
+        auto &stored = _callbacks[input] = std::move(callback);
+        _table.register_cb(
+            _self, code, [](void *user) { (*static_cast<interface::Callback *>(user))(); }, &stored);
+    }
+
+    void CPlugin::entrypoint(std::future<void> future) {
+        _table.entrypoint(
+            _self, [](void *user) { static_cast<std::future<void> *>(user)->wait(); }, &future);
+        std::lock_guard lk(_mtx);
+        _returned = true;
+        _finish_shutdown();
+    }
+
+    std::future<void> CPlugin::request_shutdown() {
+        std::future<void> future;
+        {
+            std::lock_guard lk(_mtx);
+            _shutdown.emplace();
+            _done = false;
+            future = _shutdown->get_future();
+        }
+        _table.request_shutdown(
+            _self,
+            [](void *user) {
+                auto &self = *static_cast<CPlugin *>(user);
+                std::lock_guard lk(self._mtx);
+                self._done = true;
+                self._finish_shutdown();
+            },
+            this);
+        return future;
+    }
+
+    void CPlugin::_finish_shutdown() {
+        if (!_shutdown || !_done || !_returned) return;
+        _shutdown->set_value();
+        _shutdown.reset();
+    }
+
+    void CPlugin::display_menu(interface::Menu const &menu) {
+        _options.clear();
+        for (auto option : menu.options) _options.push_back(convert(option));
+        nibbler_menu m{.name = convert(menu.name),
+                       .hover_pos = menu.hover_pos,
+                       .options = _options.data(),
+                       .option_count = _options.size()};
+        _table.display_menu(_self, &m);
+    }
+
+    void CPlugin::display_game(std::vector<interface::ARGB> const &buffer, interface::Extent extent) {
+        _table.display_game(_self, buffer.data(), extent.width, convert(extent));
+    }
+
+    interface::Extent CPlugin::cell_size() {
+        return {.width = _table.cell_size.width, .height = _table.cell_size.height};
+    }
+
+    void CPlugin::display_damage(std::vector<interface::ARGB> const &buffer, interface::Extent extent,
+                                 std::vector<interface::Rect> const &damage) {
+        if (!(_capabilities & NIBBLER_CAP_DAMAGE_RECTS)) return display_game(buffer, extent);
+        _table.display_damage(_self, buffer.data(), extent.width, convert(extent), _convert(damage), damage.size());
+    }
+
+    interface::Surface *CPlugin::acquire_surface(interface::Extent extent) {
+        if (!(_capabilities & NIBBLER_CAP_MAPPED_SURFACE)) return nullptr;
+        auto *surface = _table.acquire_surface(_self, convert(extent));
+        if (!surface) return nullptr;
+        _surface = {.pixels = surface->pixels,
+                    .stride = surface->stride,
+                    .extent = {.width = surface->extent.width, .height = surface->extent.height},
+                    .format = static_cast<interface::PixelFormat>(surface->format),
+                    .preserved = surface->preserved != 0};
+        return &_surface;
+    }
+
+    void CPlugin::present_surface(std::vector<interface::Rect> const &damage) {
+        _table.present_surface(_self, _convert(damage), damage.size());
+    }
+
+    nibbler_rect const *CPlugin::_convert(std::vector<interface::Rect> const &damage) {
+        _rects.clear();
+        for (auto [x, y, width, height] : damage) _rects.push_back({.x = x, .y = y, .width = width, .height = height});
+        return _rects.data();
+    }
+}  // namespace game::plugin
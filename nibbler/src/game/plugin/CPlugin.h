@@ -0,0 +1,77 @@
+#pragma once
+
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "plugin/IPlugin.h"
+#include "plugin/nibbler_plugin.h"
+
+namespace game::plugin {
+    /**
+     * @brief IPlugin on top of a plugin exporting the plain C ABI v2, see nibbler_plugin.h.
+     *
+     * The capabilities of the plugin decide which paths are forwarded: without NIBBLER_CAP_MAPPED_SURFACE
+     * acquire_surface() returns nullptr, and without NIBBLER_CAP_DAMAGE_RECTS display_damage() sends full frames.
+     * Either way, frames only cross the boundary as pointer + stride buffers.
+     *
+     * The future of request_shutdown() is only ready once no thread runs plugin code any more, so that the plugin can
+     * be destroyed and its shared object unloaded right away.
+     */
+    class CPlugin final : public interface::IPlugin {
+       public:
+        CPlugin(CPlugin const &) = delete;
+        CPlugin(CPlugin &&) = delete;
+        /**
+         * @param table The function table of the plugin, must outlive the CPlugin. Its required functions must not be
+         * NULL.
+         * @param capabilities The capabilities of the table to use, only those whose functions are not NULL.
+         * @throws exception::PluginInstanceException if the plugin fails to create its instance.
+         */
+        CPlugin(nibbler_plugin_v2 const &table, uint32_t capabilities);
+        ~CPlugin() override;
+
+        /** @brief The C ABI has no greet(), a fixed greeting is returned instead of asking the plugin. */
+        std::string greet() override;
+        void register_cb(interface::Input input, interface::Callback callback) override;
+        void entrypoint(std::future<void> future) override;
+        std::future<void> request_shutdown() override;
+        void display_menu(interface::Menu const &menu) override;
+        void display_game(std::vector<interface::ARGB> const &buffer, interface::Extent extent) override;
+        interface::Extent cell_size() override;
+        void display_damage(std::vector<interface::ARGB> const &buffer, interface::Extent extent,
+                            std::vector<interface::Rect> const &damage) override;
+        interface::Surface *acquire_surface(interface::Extent extent) override;
+        void present_surface(std::vector<interface::Rect> const &damage) override;
+
+       private:
+        /** @brief Converted into _rects, which keeps its capacity between frames */
+        nibbler_rect const *_convert(std::vector<interface::Rect> const &damage);
+        /** @brief Fulfil _shutdown once the plugin is done and its entrypoint returned, with _mtx held. */
+        void _finish_shutdown();
+
+        nibbler_plugin_v2 const &_table;
+        uint32_t _capabilities;
+        void *_self;
+        /** @brief Node-based, so the addresses handed to the plugin stay valid */
+        std::unordered_map<interface::Input, interface::Callback> _callbacks;
+        interface::Surface _surface{};
+        std::vector<nibbler_rect> _rects;
+        std::vector<nibbler_string> _options;
+
+        /**
+         * @brief The future of request_shutdown() is only made ready once no thread runs plugin code any more: the
+         * plugin called done, and the thread that ran the entrypoint returned from it.
+         */
+        std::mutex _mtx;
+        /**
+         * @brief The entrypoint returned. The application only shuts down plugins whose entrypoint it started, so it
+         * counts as running from construction on: a shutdown cannot complete before the entrypoint thread even ran.
+         */
+        bool _returned = false;
+        bool _done = false;
+        std::optional<std::promise<void>> _shutdown;
+    };
+}  // namespace game::plugin
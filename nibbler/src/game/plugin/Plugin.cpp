@@ -3,9 +3,21 @@
 #include <dlfcn.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+
+#include "CPlugin.h"
 #include "exception.h"
 
 namespace game::plugin {
+    namespace {
+        /** @return true if the Frame can draw an extent large frame into surface without writing out of it. */
+        bool fits(interface::Surface const& surface, interface::Extent extent) {
+            return surface.pixels && surface.format == interface::PixelFormat::ARGB8888 &&
+                   surface.extent.width == extent.width && surface.extent.height == extent.height &&
+                   surface.stride >= extent.width;
+        }
+    }  // namespace
+
     Plugin::Plugin(std::string id, std::string path) : id(std::move(id)), _path(std::move(path)) {}
 
     Plugin::~Plugin() { clear(); }
@@ -36,6 +48,11 @@ namespace game::plugin {
             throw exception::PluginHandleException();
         }
 
+        if (_load_c_abi()) {
+            SPDLOG_INFO("Plugin({}) successfully loaded!", id);
+            return;
+        }
+
         auto create = reinterpret_cast<decltype(&interface::create)>(dlsym(_handle.get(), "create"));
         if (auto e = dlerror()) {
             SPDLOG_CRITICAL("Cannot load symbol 'create': {}", e);
@@ -65,6 +82,56 @@ namespace game::plugin {
         SPDLOG_INFO("Plugin({}) successfully loaded!", id);
     }
 
+    bool Plugin::_load_c_abi() {
+        auto* handle = _handle.get();
+        auto version = reinterpret_cast<decltype(&nibbler_plugin_version)>(dlsym(handle, "nibbler_plugin_version"));
+        auto table = reinterpret_cast<decltype(&nibbler_plugin_table)>(dlsym(handle, "nibbler_plugin_table"));
+        dlerror();  // the C ABI is optional, do not leave an error behind for the C++ interface lookup
+        if (!version || !table) return false;
+
+        if (auto v = version(); v != NIBBLER_PLUGIN_ABI_VERSION) {
+            SPDLOG_WARN("Plugin({}) has C ABI v{}, expected v{}, trying the C++ interface", id, v,
+                        NIBBLER_PLUGIN_ABI_VERSION);
+            return false;
+        }
+        auto const *t = table();
+        if (!t || t->abi_version != NIBBLER_PLUGIN_ABI_VERSION || t->size < sizeof(nibbler_plugin_v2) || !t->create ||
+            !t->destroy || !t->entrypoint || !t->request_shutdown || !t->register_cb || !t->display_game ||
+            !t->display_menu) {
+            SPDLOG_WARN("Plugin({}) has an invalid C ABI table, trying the C++ interface", id);
+            return false;
+        }
+        // A capability without its functions is ignored, rather than calling through NULL
+        auto capabilities = t->capabilities;
+        if (capabilities & NIBBLER_CAP_DAMAGE_RECTS && !t->display_damage) {
+            SPDLOG_WARN("Plugin({}) claims NIBBLER_CAP_DAMAGE_RECTS without display_damage, ignored", id);
+            capabilities &= ~uint32_t(NIBBLER_CAP_DAMAGE_RECTS);
+        }
+        if (capabilities & NIBBLER_CAP_MAPPED_SURFACE && (!t->acquire_surface || !t->present_surface)) {
+            SPDLOG_WARN("Plugin({}) claims NIBBLER_CAP_MAPPED_SURFACE without acquire/present_surface, ignored", id);
+            capabilities &= ~uint32_t(NIBBLER_CAP_MAPPED_SURFACE);
+        }
+
+        auto deleter = [this](interface::IPlugin* ptr) {
+            if (!ptr) return;
+            SPDLOG_DEBUG("Destroying Plugin({})", id);
+            delete ptr;
+        };
+        try {
+            _plugin = std::unique_ptr<interface::IPlugin, decltype(deleter)>(new CPlugin(*t, capabilities),
+                                                                             std::move(deleter));
+        } catch (std::exception const& e) {
+            SPDLOG_CRITICAL("Failed to create Plugin({}) instance: {}", id, e.what());
+            clear();
+            throw exception::PluginInstanceException();
+        }
+        return true;
+    }
+
+    bool Plugin::loaded() const { return _plugin != nullptr; }
+
+    std::string const& Plugin::path() const { return _path; }
+
     void Plugin::clear() {
         _plugin.reset();
         _handle.reset();
@@ -73,13 +140,19 @@ namespace game::plugin {
     void PluginManager::switch_plugin(std::string const& new_id) {
         // Unload plugin
         if (_current != _plugins.end()) {
-            _current->second.clear();
+            if (!_resident) _current->second.clear();
             _current = _plugins.end();
         }
 
         if (auto it = _plugins.find(new_id); it != _plugins.end()) {
+            if (_resident && !it->second.loaded()) {
+                auto same = std::ranges::find_if(_plugins, [&it](auto const& item) {
+                    return item.second.loaded() && item.second.path() == it->second.path();
+                });
+                if (same != _plugins.end()) it = same;
+            }
             _current = it;
-            _current->second.load();
+            if (!_current->second.loaded()) _current->second.load();
             SPDLOG_INFO("PluginManager successfully switch to Plugin({})", new_id);
         } else {
             SPDLOG_CRITICAL("PluginManager does not manage Plugin({})!!!", new_id);
@@ -97,6 +170,31 @@ namespace game::plugin {
         return *this;
     }
 
+    void PluginManager::load_all() {
+        _resident = true;
+        for (auto& [id, plugin] : _plugins) {
+            if (plugin.loaded()) continue;
+            bool shared = std::ranges::any_of(_plugins, [&plugin](auto const& item) {
+                return item.second.loaded() && item.second.path() == plugin.path();
+            });
+            if (shared) {
+                SPDLOG_INFO("Plugin({}) shares its instance with another Plugin", id);
+                continue;
+            }
+            try {
+                plugin.load();
+            } catch (std::exception const& e) {
+                SPDLOG_ERROR("Plugin({}) skipped: {}", id, e.what());
+            }
+        }
+    }
+
+    void PluginManager::for_each_loaded(std::function<void(interface::IPlugin&)> const& f) {
+        for (auto& [_, plugin] : _plugins) {
+            if (plugin.loaded()) f(plugin.instance());
+        }
+    }
+
     interface::IPlugin& PluginManager::instance() {
         if (_current != _plugins.end())
             return _current->second.instance();
@@ -119,38 +217,105 @@ namespace game::plugin {
     }
 
     void PluginSwitcher::switch_plugin(std::string const& index) {
-        try {
-            _plugin_manager.instance().request_shutdown().wait();  // TODO: wait_for() ???
-        } catch (exception::PluginManagerNoPluginException& error) {
-            static bool blow_this_shit = false;
-            if (blow_this_shit)
-                throw error;
-            else
-                blow_this_shit = true;
-            SPDLOG_WARN("This is shit coded, expected to throw once, TODO FIX THIS CRAP");
+        std::lock_guard lk(_mtx);
+        _last_extent = {};
+        if (!_warm) {
+            if (auto* current = _active.exchange(nullptr); current) {
+                current->request_shutdown().wait();  // TODO: wait_for() ???
+            }
+            _running.clear();
         }
 
         _plugin_manager.switch_plugin(index);
-        _setup_func(_plugin_manager.instance());
+        auto& plugin = _plugin_manager.instance();
+        _setup(plugin);
+        _active = &plugin;
+        if (_menu) plugin.display_menu(*_menu);
+    }
+
+    void PluginSwitcher::warm_up() {
+        std::lock_guard lk(_mtx);
+        _warm = true;
+        _plugin_manager.load_all();
+        _plugin_manager.for_each_loaded([this](interface::IPlugin& plugin) { _setup(plugin); });
+    }
+
+    bool PluginSwitcher::active(interface::IPlugin const& plugin) const {
+        return _active.load(std::memory_order_relaxed) == &plugin;
     }
+
+    void PluginSwitcher::_setup(interface::IPlugin& plugin) {
+        if (std::ranges::find(_running, &plugin) != _running.end()) return;
+        _setup_func(plugin);
+        _running.push_back(&plugin);
+    }
+
     PluginSwitcher::~PluginSwitcher() {
-        try {
-            auto status = _plugin_manager.instance().request_shutdown().wait_for(std::chrono::seconds(1));
-            switch (status) {
+        if (_running.empty()) SPDLOG_WARN("{}", exception::PluginManagerNoPluginException().what());
+
+        // Shut every running plugin down at once, so that their shutdown delays overlap
+        std::vector<std::future<void>> futures;
+        for (auto* plugin : _running) futures.push_back(plugin->request_shutdown());
+        for (auto& future : futures) {
+            switch (future.wait_for(std::chrono::seconds(1))) {
                 case std::future_status::timeout: SPDLOG_CRITICAL("The application might kaput, oh boy!!"); break;
                 default: SPDLOG_DEBUG("No kaput, we gucci");
             }
-        } catch (exception::PluginManagerNoPluginException& error) {
-            SPDLOG_WARN("{}", error.what());
         }
     }
 
-    void PluginSwitcher::handle_event(state::Event event) {
-        switch (event) {
+    void PluginSwitcher::handle_event(state::TimedEvent event) {
+        switch (event.event) {
             case state::Event::PLUGIN_1: switch_plugin("1"); break;
             case state::Event::PLUGIN_2: switch_plugin("2"); break;
             case state::Event::PLUGIN_3: switch_plugin("3"); break;
-            default: SPDLOG_DEBUG("Ignoring event {}", toString(event));
+            default: SPDLOG_DEBUG("Ignoring event {}", toString(event.event));
+        }
+    }
+
+    void PluginSwitcher::display_game(render::Frame& frame, snake::Matrix<snake::Entity> const& m,
+                                      snake::Damage const& damage) {
+        std::lock_guard lk(_mtx);
+        _menu.reset();
+        try {
+            auto& plugin = _plugin_manager.instance();
+            frame.rescale(plugin.cell_size());
+            auto extent = frame.extent();
+            bool stale = extent.width != _last_extent.width || extent.height != _last_extent.height;
+            auto *surface = plugin.acquire_surface(extent);
+            if (surface && !fits(*surface, extent)) {
+                SPDLOG_WARN("Plugin lent a {}x{} surface for a {}x{} frame, falling back to display_game()",
+                            surface->extent.width, surface->extent.height, extent.width, extent.height);
+                plugin.present_surface({});  // hand it back untouched
+                surface = nullptr;
+            }
+            // The Frame's own buffer is not kept up to date while drawing into surfaces, and the other way round
+            if ((surface != nullptr) != _last_surface) stale = true;
+            if (surface) {
+                frame.draw(m, damage, {.pixels = surface->pixels, .stride = surface->stride},
+                           stale || !surface->preserved);
+                plugin.present_surface(frame.damage());
+            } else {
+                frame.draw(m, damage, stale);
+                if (frame.full())
+                    plugin.display_game(frame.buffer(), extent);
+                else if (!frame.damage().empty())
+                    plugin.display_damage(frame.buffer(), extent, frame.damage());
+            }
+            _last_extent = extent;
+            _last_surface = surface != nullptr;
+        } catch (exception::PluginManagerNoPluginException& error) {
+            SPDLOG_WARN("{}", error.what());
+        }
+    }
+
+    void PluginSwitcher::display_menu(interface::Menu const& menu) {
+        std::lock_guard lk(_mtx);
+        _menu = menu;
+        try {
+            _plugin_manager.instance().display_menu(menu);
+        } catch (exception::PluginManagerNoPluginException& error) {
+            SPDLOG_WARN("{}", error.what());
         }
     }
 }  // namespace game::plugin
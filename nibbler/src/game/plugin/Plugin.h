@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <span>
 
+#include "game/render/Frame.h"
 #include "game/state/Event.h"
 #include "plugin/IPlugin.h"
 
@@ -55,14 +59,29 @@ namespace game::plugin {
          *
          * This will make the plugin instance available for usage.
          * This method must always be called before using the instance() method.
+         * The plain C ABI (see nibbler_plugin.h) is preferred when the shared object exports it, otherwise the
+         * C++ interface create() / destroy() is used.
          */
         void load();
 
+        /** @return true if the instance is loaded. */
+        [[nodiscard]] bool loaded() const;
+
+        /** @return The path to the shared object. */
+        [[nodiscard]] std::string const &path() const;
+
        public:
         /** @brief Unique Identifier */
         const std::string id;
 
        private:
+        /**
+         * @brief Load the instance through the C ABI.
+         * @returns false if the shared object does not export it, or exports a table missing required functions.
+         * @throws exception::PluginInstanceException if the instance cannot be created, the Plugin being cleared.
+         */
+        bool _load_c_abi();
+
         /** @brief Path to the shared object */
         const std::string _path;
         /** @brief Pointer to the plugin instance */
@@ -74,9 +93,11 @@ namespace game::plugin {
     /**
      * @brief The PluginManager class, responsible for managing multiple plugins.
      *
-     * This class guarantees that only one plugin is loaded at the time, and that the Plugin api is used as expected.
-     * when switching Plugin, the previously loaded Plugin is destroyed and a new one is loaded. It also allows you to
-     * use the current instance with the instance() method, similar to Plugin::instance().
+     * By default, this class guarantees that only one plugin is loaded at the time, and that the Plugin api is used
+     * as expected. when switching Plugin, the previously loaded Plugin is destroyed and a new one is loaded. It also
+     * allows you to use the current instance with the instance() method, similar to Plugin::instance().
+     *
+     * After load_all(), every Plugin stays resident instead, and switching only changes the current one.
      */
     class PluginManager {
         using iterator = std::unordered_map<std::string, Plugin>::iterator;
@@ -103,6 +124,17 @@ namespace game::plugin {
          */
         void switch_plugin(std::string const &new_id);
 
+        /**
+         * @brief Load every Plugin and keep them resident from now on.
+         *
+         * Plugins sharing the same shared object share a single instance, as dlopen() would give them the same
+         * handle, thus the same globals. A Plugin failing to load is skipped.
+         */
+        void load_all();
+
+        /** @brief Call f with every loaded Plugin instance. */
+        void for_each_loaded(std::function<void(interface::IPlugin &)> const &f);
+
         /**
          * @brief The currently loaded Plugin instance.
          *
@@ -113,6 +145,8 @@ namespace game::plugin {
        private:
         /** @brief The iterator to the currently loaded instance, if any */
         iterator _current{};
+        /** @brief Plugins stay loaded when switching */
+        bool _resident = false;
         /** @brief The map that holds the plugins, where the key is the Plugin UID */
         std::unordered_map<std::string, Plugin> _plugins{};
     };
@@ -123,7 +157,8 @@ namespace game::plugin {
      * Responsible registering a function that will be called after switching the plugin.
      *
      * PluginSwitcher asks the PluginManager to switch Plugin, before switching it will request the Plugin instance to
-     * gracefully shutdown. After switching it will call the registered function.
+     * gracefully shutdown. After switching it will call the registered function. After warm_up(), every Plugin is
+     * set up once and kept running instead, and switching is only a matter of redirecting frames and input.
      *
      * it will also expose a way to handle events for the event handler.
      */
@@ -159,11 +194,70 @@ namespace game::plugin {
          */
         void switch_plugin(std::string const &index);
 
+        /**
+         * @brief Load and set up every plugin once, then keep them running.
+         *
+         * From then on, switch_plugin() only redirects frames and input to another resident plugin, the previous one
+         * is neither shut down nor unloaded. The setup function is called once per plugin instance.
+         */
+        void warm_up();
+
+        /**
+         * @brief Whether plugin is the one frames are currently delivered to.
+         *
+         * Lock-free, meant for the plugin callbacks to drop input from inactive resident plugins.
+         */
+        [[nodiscard]] bool active(interface::IPlugin const &plugin) const;
+
+        /** @brief The Events handle_event() is interested in */
+        static constexpr state::EventSet EVENTS{state::Event::PLUGIN_1, state::Event::PLUGIN_2, state::Event::PLUGIN_3};
+
         /** @brief Method to be called by the event handler class */
-        void handle_event(state::Event event);
+        void handle_event(state::TimedEvent event);
+
+        /**
+         * @brief Draw a Snake board through the given Frame and deliver it to the current plugin, if any.
+         *
+         * The Frame is first rescaled to the cell size the plugin asks for, see IPlugin::cell_size().
+         *
+         * When the plugin lends a Surface, the Frame draws straight into it and no copy is made. Otherwise the Frame
+         * draws into its own buffer, which is sent through IPlugin::display_damage() whenever possible. A full
+         * redraw is forced when the current plugin has not received a full frame of that extent yet, or when the
+         * frames switch between the Surface and the buffer, each missing the frames drawn into the other. A Surface
+         * that does not match the extent, stride or format of the Frame is handed back untouched, and the Frame falls
+         * back to its own buffer.
+         *
+         * @param frame The Frame used to draw the board.
+         * @param m The board to be displayed.
+         * @param damage The cells changed since the previous call.
+         */
+        void display_game(render::Frame &frame, snake::Matrix<snake::Entity> const &m, snake::Damage const &damage);
+
+        /**
+         * @brief Deliver a Menu to the current plugin, if any.
+         *
+         * The Menu is kept until the next display_game(), and shown again by any plugin switched to meanwhile.
+         */
+        void display_menu(interface::Menu const &menu);
 
        private:
+        /** @brief Call the setup function with plugin, unless already done, with _mtx held */
+        void _setup(interface::IPlugin &plugin);
+
         PluginManager _plugin_manager;
         std::function<void(interface::IPlugin &)> _setup_func;
+        /** @brief Serializes plugin switches against frame delivery */
+        std::mutex _mtx;
+        /** @brief Extent of the last full frame received by the current plugin, {0, 0} if none */
+        interface::Extent _last_extent{};
+        /** @brief The last frame was drawn into a Surface rather than the Frame's own buffer */
+        bool _last_surface = false;
+        /** @brief The Menu on screen, if any */
+        std::optional<interface::Menu> _menu;
+        /** @brief Plugins kept resident, see warm_up() */
+        bool _warm = false;
+        /** @brief Plugin instances the setup function was called with, and not shut down since */
+        std::vector<interface::IPlugin *> _running;
+        std::atomic<interface::IPlugin *> _active{nullptr};
     };
 }  // namespace game::plugin
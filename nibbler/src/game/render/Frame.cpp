@@ -0,0 +1,116 @@
+#include "Frame.h"
+
+#include <algorithm>
+
+#include "game/render/Upscale.h"
+
+namespace game::render {
+    Frame::Frame(Extent board, Extent scale, Palette const &palette)
+        : _board(board),
+          _default_scale(scale),
+          _scale(scale),
+          _extent{.width = board.width * scale.width, .height = board.height * scale.height},
+          _palette(palette) {
+        _damage.reserve(MAX_DAMAGE_RECTS + 1);
+        _scratch.reserve(snake::Damage::CAPACITY);
+    }
+
+    void Frame::draw(snake::Matrix<snake::Entity> const &m, snake::Damage const &damage, Target target,
+                     bool force_full) {
+        _damage.clear();
+        _full = force_full || damage.full() || _moved;
+        _moved = false;
+
+        if (!_full) {
+            _scratch.clear();
+            for (auto [x, y] : damage.cells()) {
+                if (x < _origin.x || y < _origin.y || x - _origin.x >= _board.width || y - _origin.y >= _board.height)
+                    continue;
+                _scratch.push_back({.x = x - _origin.x, .y = y - _origin.y});
+            }
+            std::sort(_scratch.begin(), _scratch.end(),
+                      [](auto a, auto b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+
+            for (auto [x, y] : _scratch) {
+                if (!_damage.empty()) {
+                    auto &last = _damage.back();
+                    if (last.y == y && x >= last.x && x <= last.x + last.width) {
+                        last.width = std::max(last.width, x - last.x + 1);  // duplicate or adjacent cell
+                        continue;
+                    }
+                }
+                if (_damage.size() == MAX_DAMAGE_RECTS) {
+                    _full = true;
+                    break;
+                }
+                _damage.push_back({.x = x, .y = y, .width = 1, .height = 1});
+            }
+        }
+        if (_full) _damage.assign(1, {.x = 0, .y = 0, .width = _board.width, .height = _board.height});
+
+        for (auto &rect : _damage) {
+            _paint(m, rect, target);
+            rect = {.x = rect.x * _scale.width,
+                    .y = rect.y * _scale.height,
+                    .width = rect.width * _scale.width,
+                    .height = rect.height * _scale.height};
+        }
+    }
+
+    void Frame::_paint(snake::Matrix<snake::Entity> const &m, Rect cells, Target target) const {
+        size_t const width = size_t(cells.width) * _scale.width;
+        for (size_t y = cells.y; y < cells.y + cells.height; ++y) {
+            ARGB *row = target.pixels + y * _scale.height * target.stride + size_t(cells.x) * _scale.width;
+            // The row is contiguous only up to the edge of a Matrix tile
+            auto *out = row;
+            for (size_t x = _origin.x + cells.x, end = x + cells.width; x < end;) {
+                auto segment = m.segment(x, _origin.y + y);
+                auto count = std::min(segment.size(), end - x);
+                expand_row(segment.data(), count, _palette, _scale.width, out);
+                out += count * _scale.width;
+                x += count;
+            }
+            for (size_t k = 1; k < _scale.height; ++k) std::copy_n(row, width, row + k * target.stride);
+        }
+    }
+
+    void Frame::draw(snake::Matrix<snake::Entity> const &m, snake::Damage const &damage, bool force_full) {
+        if (_buffer.empty()) {
+            _buffer.resize(size_t(_extent.width) * _extent.height);
+            force_full = true;
+        }
+        draw(m, damage, {.pixels = _buffer.data(), .stride = _extent.width}, force_full);
+    }
+
+    void Frame::follow(snake::Cell cell, Extent board) {
+        auto axis = [](uint32_t at, uint32_t origin, uint32_t window, uint32_t size) {
+            auto margin = window / 4;
+            if (at >= origin + margin && at < origin + window - margin) return origin;
+            auto centred = at > window / 2 ? at - window / 2 : 0;
+            return std::min(centred, size - std::min(size, window));
+        };
+        snake::Cell origin{.x = axis(cell.x, _origin.x, _board.width, board.width),
+                           .y = axis(cell.y, _origin.y, _board.height, board.height)};
+        if (origin.x == _origin.x && origin.y == _origin.y) return;
+        _origin = origin;
+        _moved = true;
+    }
+
+    snake::Cell Frame::origin() const { return _origin; }
+
+    void Frame::rescale(Extent scale) {
+        if (!scale.width || !scale.height) scale = _default_scale;
+        if (scale.width == _scale.width && scale.height == _scale.height) return;
+        _scale = scale;
+        _extent = {.width = _board.width * scale.width, .height = _board.height * scale.height};
+        _buffer.clear();  // reallocated, and fully repainted, by the next draw()
+    }
+
+    bool Frame::full() const { return _full; }
+
+    std::vector<Rect> const &Frame::damage() const { return _damage; }
+
+    std::vector<ARGB> const &Frame::buffer() const { return _buffer; }
+
+    Extent Frame::extent() const { return _extent; }
+}  // namespace game::render
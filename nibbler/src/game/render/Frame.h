@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+
+#include "game/render/Palette.h"
+#include "game/snake/Snake.h"
+#include "plugin/IPlugin.h"
+
+namespace game::render {
+    using interface::ARGB;
+    using interface::Extent;
+    using interface::Rect;
+
+    /** @brief Pixel memory a Frame can be drawn into. */
+    struct Target {
+        /** @brief First pixel of the first row */
+        ARGB *pixels;
+        /** @brief Distance between the start of two consecutive rows, in pixels */
+        size_t stride;
+    };
+
+    /**
+     * @brief The pixel representation of a Snake board, as sent to the plugins.
+     *
+     * Each cell is drawn as a scale.width x scale.height block of its palette colour (see expand_row()).
+     *
+     * The Frame only repaints the cells recorded in a snake::Damage. The repainted cells are coalesced into horizontal
+     * runs and exposed as damage rectangles, unless there are too many of them, in which case the Frame asks for a
+     * full redraw instead.
+     *
+     * A Frame can draw either into a Target owned by someone else (e.g. a plugin Surface), or into its own buffer,
+     * which is only allocated the first time it is needed.
+     *
+     * The Frame is a window over the board: it may be smaller than the board, in which case only the cells inside the
+     * window are ever read, and follow() moves it along with the Player. The cost of a frame is proportional to the
+     * window, whatever the size of the board.
+     */
+    class Frame {
+       public:
+        /** @brief Past this number of rectangles a full frame is cheaper to send than the damage list */
+        static constexpr size_t MAX_DAMAGE_RECTS = 16;
+
+        /**
+         * @brief Frame constructor.
+         * @param board The dimensions of the window over the board, in cells.
+         * @param scale The dimensions of a cell, in pixels.
+         * @param palette The colour of each cell.
+         */
+        explicit Frame(Extent board, Extent scale = {1, 1}, Palette const &palette = DEFAULT_PALETTE);
+
+        /**
+         * @brief Repaint the damaged cells of the board into target.
+         * @param m The board to draw.
+         * @param damage The cells changed since the previous draw().
+         * @param target The pixels to draw into, at least extent() large.
+         * @param force_full Repaint the whole board, regardless of damage.
+         */
+        void draw(snake::Matrix<snake::Entity> const &m, snake::Damage const &damage, Target target, bool force_full);
+
+        /** @brief Same as above, drawing into the Frame's own buffer(). */
+        void draw(snake::Matrix<snake::Entity> const &m, snake::Damage const &damage, bool force_full);
+
+        /**
+         * @brief Move the window so that a cell stays well inside it, the next draw() repaints it fully if it moved.
+         *
+         * The window only moves once the cell gets closer than a quarter of the window to its edge, and is then
+         * centred on the cell, so that it does not scroll (and repaint everything) on every move.
+         *
+         * @param cell The cell to keep in view, usually the head of the Player.
+         * @param board The dimensions of the whole board, in cells. The window never goes past its edges.
+         */
+        void follow(snake::Cell cell, Extent board);
+
+        /** @return The board cell drawn at the top-left corner of the frame. */
+        [[nodiscard]] snake::Cell origin() const;
+
+        /**
+         * @brief Change the dimensions of a cell, the next draw() repaints the whole board if they differ.
+         * @param scale The dimensions of a cell, in pixels. {0, 0} restores the one given to the constructor.
+         */
+        void rescale(Extent scale);
+
+        /** @return true if the last draw() repainted the whole board. */
+        [[nodiscard]] bool full() const;
+        /** @return The regions repainted by the last draw(). A single rectangle covering extent() if full(). */
+        [[nodiscard]] std::vector<Rect> const &damage() const;
+        /** @return The Frame's own buffer, row-major and tightly packed. */
+        [[nodiscard]] std::vector<ARGB> const &buffer() const;
+        /** @return The dimensions of the frame, in pixels. */
+        [[nodiscard]] Extent extent() const;
+
+       private:
+        void _paint(snake::Matrix<snake::Entity> const &m, Rect cells, Target target) const;
+
+        /** @brief The window, in cells */
+        Extent _board;
+        snake::Cell _origin{0, 0};
+        bool _moved = false;
+        Extent _default_scale;
+        Extent _scale;
+        Extent _extent;
+        Palette _palette;
+        std::vector<ARGB> _buffer;
+        std::vector<Rect> _damage;
+        std::vector<snake::Cell> _scratch;
+        bool _full = true;
+    };
+}  // namespace game::render
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+
+#include "game/snake/Snake.h"
+#include "plugin/IPlugin.h"
+
+namespace game::render {
+    using interface::ARGB;
+    static_assert(sizeof(ARGB) == 4, "ARGB must have 4 bytes");
+
+    constexpr ARGB BLACK = 0x00000000;
+    constexpr ARGB WHITE = 0x00FFFFFF;
+    constexpr ARGB RED = 0x00FF0000;
+    constexpr ARGB YELLOW = 0x00FCBA03;
+    constexpr ARGB GREEN = 0x000000FF;
+
+    /** @brief Colour of each snake::Entity, indexed by its code. */
+    using Palette = std::array<ARGB, snake::ENTITY_COUNT>;
+
+    constexpr Palette DEFAULT_PALETTE = {
+        BLACK,   // Background
+        WHITE,   // Wall
+        RED,     // Head
+        YELLOW,  // Body
+        GREEN,   // Food
+    };
+
+    constexpr ARGB colour(Palette const &palette, snake::Entity entity) {
+        return palette[static_cast<size_t>(entity)];
+    }
+}  // namespace game::render
@@ -0,0 +1,113 @@
+#include "Upscale.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NIBBLER_X86
+#endif
+
+namespace game::render {
+    namespace {
+        using Kernel = void (*)(snake::Entity const *, size_t, Palette const &, uint32_t, ARGB *);
+
+        void expand_scalar(snake::Entity const *cells, size_t count, Palette const &palette, uint32_t scale,
+                           ARGB *out) {
+            for (size_t i = 0; i < count; ++i, out += scale) std::fill_n(out, scale, colour(palette, cells[i]));
+        }
+
+#ifdef NIBBLER_X86
+        __attribute__((target("sse2"))) void expand_sse2(snake::Entity const *cells, size_t count,
+                                                         Palette const &palette, uint32_t scale, ARGB *out) {
+            for (size_t i = 0; i < count; ++i, out += scale) {
+                auto c = colour(palette, cells[i]);
+                auto v = _mm_set1_epi32(static_cast<int>(c));
+                uint32_t k = 0;
+                for (; k + 4 <= scale; k += 4) _mm_storeu_si128(reinterpret_cast<__m128i *>(out + k), v);
+                for (; k < scale; ++k) out[k] = c;
+            }
+        }
+
+        __attribute__((target("avx2"))) inline void fill_avx2(ARGB *out, ARGB c, uint32_t scale) {
+            auto v = _mm256_set1_epi32(static_cast<int>(c));
+            uint32_t k = 0;
+            for (; k + 8 <= scale; k += 8) _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + k), v);
+            for (; k < scale; ++k) out[k] = c;
+        }
+
+        __attribute__((target("avx2"))) void expand_avx2(snake::Entity const *cells, size_t count,
+                                                         Palette const &palette, uint32_t scale, ARGB *out) {
+            static_assert(snake::ENTITY_COUNT <= 8, "the palette must fit in a single AVX2 register");
+            alignas(32) std::array<ARGB, 8> lut{};
+            std::copy(palette.begin(), palette.end(), lut.begin());
+            auto const table = _mm256_load_si256(reinterpret_cast<__m256i const *>(lut.data()));
+
+            size_t i = 0;
+            alignas(32) std::array<ARGB, 8> colours;
+            for (; i + 8 <= count; i += 8) {
+                // 8 entity codes -> 8 palette indices -> 8 colours, in a single permute
+                auto codes = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(cells + i));
+                auto pixels = _mm256_permutevar8x32_epi32(table, _mm256_cvtepu8_epi32(codes));
+                if (scale == 1) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), pixels);
+                    out += 8;
+                    continue;
+                }
+                _mm256_store_si256(reinterpret_cast<__m256i *>(colours.data()), pixels);
+                for (auto c : colours) {
+                    fill_avx2(out, c, scale);
+                    out += scale;
+                }
+            }
+            for (; i < count; ++i, out += scale) fill_avx2(out, colour(palette, cells[i]), scale);
+        }
+#endif
+
+        Kernel kernel(Isa isa) {
+            switch (isa) {
+#ifdef NIBBLER_X86
+                case Isa::AVX2: return expand_avx2;
+                case Isa::SSE2: return expand_sse2;
+#endif
+                default: return expand_scalar;
+            }
+        }
+
+        Isa detect() {
+#ifdef NIBBLER_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+            if (__builtin_cpu_supports("sse2")) return Isa::SSE2;
+#endif
+            return Isa::SCALAR;
+        }
+    }  // namespace
+
+    char const *toString(Isa isa) {
+        switch (isa) {
+            case Isa::SCALAR: return "SCALAR";
+            case Isa::SSE2: return "SSE2";
+            case Isa::AVX2: return "AVX2";
+        }
+        return "UNKNOWN";
+    }
+
+    Isa isa() {
+        static Isa const detected = [] {
+            auto isa = detect();
+            SPDLOG_INFO("Render kernel: {}", toString(isa));
+            return isa;
+        }();
+        return detected;
+    }
+
+    void expand_row(snake::Entity const *cells, size_t count, Palette const &palette, uint32_t scale, ARGB *out) {
+        static Kernel const selected = kernel(isa());
+        selected(cells, count, palette, scale, out);
+    }
+
+    void expand_row(Isa isa, snake::Entity const *cells, size_t count, Palette const &palette, uint32_t scale,
+                    ARGB *out) {
+        kernel(isa)(cells, count, palette, scale, out);
+    }
+}  // namespace game::render
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "game/render/Palette.h"
+#include "game/snake/Snake.h"
+
+namespace game::render {
+    /** @brief Instruction set used by expand_row(), picked once at runtime from what the CPU supports. */
+    enum class Isa { SCALAR, SSE2, AVX2 };
+
+    char const *toString(Isa isa);
+
+    /** @return The instruction set expand_row() runs with. */
+    Isa isa();
+
+    /**
+     * @brief Expand a row of cells into a row of pixels: each cell becomes scale consecutive pixels of its colour.
+     * @param cells The first cell of the row.
+     * @param count The number of cells to expand.
+     * @param palette The colour of each cell.
+     * @param scale The number of pixels per cell.
+     * @param out The first pixel of the row, count * scale pixels are written.
+     */
+    void expand_row(snake::Entity const *cells, size_t count, Palette const &palette, uint32_t scale, ARGB *out);
+
+    /** @brief Same as above, forcing an instruction set the CPU is known to support, to compare the kernels. */
+    void expand_row(Isa isa, snake::Entity const *cells, size_t count, Palette const &palette, uint32_t scale,
+                    ARGB *out);
+}  // namespace game::render
@@ -0,0 +1,176 @@
+#include "Bitboard.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NIBBLER_X86
+#endif
+
+namespace game::snake {
+    namespace {
+        /**
+         * @brief Spread the bits of g to both sides, through the set bits of p only (Kogge-Stone occluded fill).
+         * Bits do not cross the word boundary.
+         */
+        constexpr uint64_t fill(uint64_t g, uint64_t p) {
+            auto up = g, up_p = p;
+            auto down = g, down_p = p;
+            for (int shift = 1; shift < 64; shift *= 2) {
+                up |= up_p & (up << shift);
+                up_p &= up_p << shift;
+                down |= down_p & (down >> shift);
+                down_p &= down_p >> shift;
+            }
+            return up | down;
+        }
+
+        /**
+         * @brief Flood the words of a row: what is reached above, below or on the row spreads into its free cells.
+         * @returns true if a cell of the row was reached for the first time.
+         */
+        using Kernel = bool (*)(uint64_t const *above, uint64_t const *row, uint64_t const *below,
+                                uint64_t const *blocked, uint64_t *out, size_t words);
+
+        bool flood_scalar(uint64_t const *above, uint64_t const *row, uint64_t const *below, uint64_t const *blocked,
+                          uint64_t *out, size_t words) {
+            uint64_t changed = 0;
+            for (size_t i = 0; i < words; ++i) {
+                out[i] = fill((above[i] | row[i] | below[i]) & ~blocked[i], ~blocked[i]);
+                changed |= out[i] ^ row[i];
+            }
+            return changed;
+        }
+
+#ifdef NIBBLER_X86
+        __attribute__((target("avx2"))) inline __m256i load(uint64_t const *p) {
+            return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+        }
+
+        __attribute__((target("avx2"))) inline __m256i fill_avx2(__m256i g, __m256i p) {
+            auto up = g, up_p = p;
+            auto down = g, down_p = p;
+            for (int shift = 1; shift < 64; shift *= 2) {
+                auto count = _mm_cvtsi32_si128(shift);
+                up = _mm256_or_si256(up, _mm256_and_si256(up_p, _mm256_sll_epi64(up, count)));
+                up_p = _mm256_and_si256(up_p, _mm256_sll_epi64(up_p, count));
+                down = _mm256_or_si256(down, _mm256_and_si256(down_p, _mm256_srl_epi64(down, count)));
+                down_p = _mm256_and_si256(down_p, _mm256_srl_epi64(down_p, count));
+            }
+            return _mm256_or_si256(up, down);
+        }
+
+        __attribute__((target("avx2"))) bool flood_avx2(uint64_t const *above, uint64_t const *row,
+                                                        uint64_t const *below, uint64_t const *blocked, uint64_t *out,
+                                                        size_t words) {
+            auto changed = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= words; i += 4) {
+                auto current = load(row + i);
+                auto reached = _mm256_or_si256(_mm256_or_si256(load(above + i), current), load(below + i));
+                auto free = _mm256_andnot_si256(load(blocked + i), _mm256_set1_epi64x(-1));
+                auto flooded = fill_avx2(_mm256_and_si256(reached, free), free);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), flooded);
+                changed = _mm256_or_si256(changed, _mm256_xor_si256(flooded, current));
+            }
+            bool any = !_mm256_testz_si256(changed, changed);
+            return flood_scalar(above + i, row + i, below + i, blocked + i, out + i, words - i) || any;
+        }
+#endif
+
+        Kernel flood_kernel(Bitboard::Kernel kernel) {
+            switch (kernel) {
+#ifdef NIBBLER_X86
+                case Bitboard::Kernel::AVX2: return flood_avx2;
+#endif
+                default: return flood_scalar;
+            }
+        }
+
+        Bitboard::Kernel detect() {
+#ifdef NIBBLER_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return Bitboard::Kernel::AVX2;
+#endif
+            return Bitboard::Kernel::SCALAR;
+        }
+
+        /** @brief Let the reached cells cross the word boundaries of a flooded row */
+        bool carry(uint64_t const *blocked, uint64_t *row, size_t words) {
+            bool changed = false;
+            for (bool again = true; again;) {
+                again = false;
+                for (size_t i = 0; i < words; ++i) {
+                    auto in = (i > 0 ? row[i - 1] >> 63 : 0) | (i + 1 < words ? row[i + 1] << 63 : 0);
+                    if (auto fresh = in & ~blocked[i] & ~row[i]; fresh) {
+                        row[i] = fill(row[i] | fresh, ~blocked[i]);
+                        again = changed = true;
+                    }
+                }
+            }
+            return changed;
+        }
+    }  // namespace
+
+    char const *Bitboard::toString(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::AVX2: return "AVX2";
+            default: return "SCALAR";
+        }
+    }
+
+    Bitboard::Kernel Bitboard::kernel() {
+        static Kernel const detected = detect();
+        return detected;
+    }
+
+    Bitboard::Bitboard(size_t width, size_t height)
+        : _width(width),
+          _height(height),
+          _words((width + 63) / 64),
+          _bits(height * _words, 0) {
+        // The padding bits at the end of each row are walls
+        if (auto used = width % 64; used) {
+            auto padding = ~uint64_t(0) << used;
+            for (size_t y = 0; y < height; ++y) _bits[_word(width - 1, y)] |= padding;
+        }
+    }
+
+    uint32_t Bitboard::free_neighbours(size_t x, size_t y) const {
+        return 4 - (blocked(x, y - 1) + blocked(x, y + 1) + blocked(x - 1, y) + blocked(x + 1, y));
+    }
+
+    size_t Bitboard::reachable(size_t x, size_t y) const { return reachable(kernel(), x, y); }
+
+    size_t Bitboard::reachable(Kernel k, size_t x, size_t y) const {
+        if (blocked(x, y)) return 0;
+        auto const flood = flood_kernel(k);
+        if (_reach.empty()) {
+            _reach.resize((_height + 2) * _words);
+            _row.resize(_words);
+        }
+        std::fill(_reach.begin(), _reach.end(), 0);
+        // Row y of the board is row y + 1 of _reach
+        auto reach = [this](size_t y) { return &_reach[(y + 1) * _words]; };
+        reach(y)[x / 64] = uint64_t(1) << (x % 64);
+
+        // Sweep down then up, until a sweep reaches nothing new
+        auto sweep = [&](size_t y) {
+            auto const *walls = &_bits[y * _words];
+            bool changed = flood(reach(y - 1), reach(y), reach(y + 1), walls, _row.data(), _words);
+            changed |= carry(walls, _row.data(), _words);
+            std::copy(_row.begin(), _row.end(), reach(y));
+            return changed;
+        };
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (size_t row = 0; row < _height; ++row) changed |= sweep(row);
+            for (size_t row = _height; row-- > 0;) changed |= sweep(row);
+        }
+
+        size_t count = 0;
+        for (auto word : _reach) count += std::popcount(word);
+        return count;
+    }
+}  // namespace game::snake
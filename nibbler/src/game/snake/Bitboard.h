@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game::snake {
+    /**
+     * @brief One bit per board cell, set when the cell is blocked (wall or snake).
+     *
+     * Each row is padded to whole 64-bit words, the padding bits are blocked. The cells of a row are tested 64 at
+     * a time: reachable() floods a row in a few shifts and masks per word instead of one cell at a time, and is
+     * vectorized with AVX2 when the CPU supports it.
+     *
+     * The scratch memory of reachable() is allocated by the first query and reused, so that a board that is never
+     * queried does not pay for it, but a Bitboard must not be queried from two threads at once.
+     */
+    class Bitboard {
+       public:
+        /** @brief Implementation of the flood fill, picked once at runtime from what the CPU supports. */
+        enum class Kernel { SCALAR, AVX2 };
+
+        static char const *toString(Kernel kernel);
+        /** @return The Kernel reachable() runs with. */
+        static Kernel kernel();
+
+        /** @brief Bitboard constructor, every cell starts free. */
+        Bitboard(size_t width, size_t height);
+
+        void set(size_t x, size_t y, bool blocked) {
+            auto &word = _bits[_word(x, y)];
+            auto bit = uint64_t(1) << (x % 64);
+            word = blocked ? word | bit : word & ~bit;
+        }
+
+        [[nodiscard]] bool blocked(size_t x, size_t y) const { return (_bits[_word(x, y)] >> (x % 64)) & 1; }
+
+        /** @return The number of free cells among the 4 neighbours of a cell, which must not be on the border. */
+        [[nodiscard]] uint32_t free_neighbours(size_t x, size_t y) const;
+
+        /**
+         * @brief Flood fill from a cell, through the 4-connected free cells.
+         * @returns The number of free cells reachable from (x, y), itself included. 0 if (x, y) is blocked.
+         */
+        [[nodiscard]] size_t reachable(size_t x, size_t y) const;
+
+        /** @brief Same as above, forcing a Kernel the CPU is known to support. */
+        [[nodiscard]] size_t reachable(Kernel kernel, size_t x, size_t y) const;
+
+        /** @return The words of row y, bit x % 64 of word x / 64 being the cell (x, y). */
+        [[nodiscard]] uint64_t const *row(size_t y) const { return &_bits[y * _words]; }
+        [[nodiscard]] size_t words() const { return _words; }
+
+       private:
+        [[nodiscard]] size_t _word(size_t x, size_t y) const { return y * _words + x / 64; }
+
+        size_t _width;
+        size_t _height;
+        /** @brief Words per row */
+        size_t _words;
+        std::vector<uint64_t> _bits;
+        /** @brief Cells reached by the flood fill, with an empty row above and below the board */
+        mutable std::vector<uint64_t> _reach;
+        /** @brief The row being flooded */
+        mutable std::vector<uint64_t> _row;
+    };
+}  // namespace game::snake
@@ -0,0 +1,26 @@
+#include "Damage.h"
+
+namespace game::snake {
+    void Damage::mark(size_t x, size_t y) {
+        if (_full) return;
+        if (_size == CAPACITY) {
+            mark_all();
+            return;
+        }
+        _cells[_size++] = {static_cast<uint32_t>(x), static_cast<uint32_t>(y)};
+    }
+
+    void Damage::mark_all() {
+        _full = true;
+        _size = 0;
+    }
+
+    void Damage::clear() {
+        _full = false;
+        _size = 0;
+    }
+
+    bool Damage::full() const { return _full; }
+
+    std::span<Cell const> Damage::cells() const { return {_cells.data(), _size}; }
+}  // namespace game::snake
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace game::snake {
+    /** @brief Coordinates of a single board cell. */
+    struct Cell {
+        uint32_t x;
+        uint32_t y;
+    };
+
+    /**
+     * @brief Records the board cells changed during a tick.
+     *
+     * A move changes at most a handful of cells (old tail, old head, new head and food), so the cells are kept in a
+     * small fixed buffer without any allocation. When more than CAPACITY cells are marked, or mark_all() is called,
+     * the damage collapses into a full redraw. A new Damage starts as a full redraw.
+     */
+    class Damage {
+       public:
+        static constexpr size_t CAPACITY = 32;
+
+        /** @brief Mark a single cell as changed. */
+        void mark(size_t x, size_t y);
+        /** @brief Mark the whole board as changed. */
+        void mark_all();
+        /** @brief Forget every recorded change, to be called once the damage has been consumed. */
+        void clear();
+
+        /** @return true if the whole board must be redrawn. */
+        [[nodiscard]] bool full() const;
+        /** @return The changed cells, possibly with duplicates. Meaningless if full() is true. */
+        [[nodiscard]] std::span<Cell const> cells() const;
+
+       private:
+        std::array<Cell, CAPACITY> _cells{};
+        size_t _size = 0;
+        bool _full = true;
+    };
+}  // namespace game::snake
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace game::snake {
+    /**
+     * @brief The pages of an array written since the last clear(), for snapshotting only what changed.
+     *
+     * A page is PAGE_BYTES of consecutive elements. mark() is a bit test on the hot path, and the first write to a
+     * page appends it to a list, so the dirty pages are enumerated without scanning the array. Nothing allocates
+     * after construction.
+     *
+     * @tparam T Element type of the tracked array.
+     */
+    template <class T>
+    class DirtyPages {
+       public:
+        static constexpr size_t PAGE_BYTES = 4096;
+        static constexpr size_t PAGE_SIZE = PAGE_BYTES / sizeof(T);
+        static_assert((PAGE_SIZE & (PAGE_SIZE - 1)) == 0, "Page size must be a power of two");
+
+        /** @param size Number of elements of the tracked array. */
+        explicit DirtyPages(size_t size) : _marked((size + PAGE_SIZE - 1) / PAGE_SIZE, 0) {
+            _pages.reserve(_marked.size());
+        }
+
+        /** @brief The element at index was written. */
+        void mark(size_t index) { mark_page(index / PAGE_SIZE); }
+
+        /** @brief An element of the page was written. */
+        void mark_page(size_t page) {
+            if (_marked[page]) return;
+            _marked[page] = 1;
+            _pages.push_back(static_cast<uint32_t>(page));
+        }
+
+        /** @brief Forget every dirty page. */
+        void clear() {
+            for (auto page : _pages) _marked[page] = 0;
+            _pages.clear();
+        }
+
+        /** @return The pages written since the last clear(), in the order of their first write. */
+        [[nodiscard]] std::span<uint32_t const> pages() const { return _pages; }
+        /** @return The number of pages of the tracked array. */
+        [[nodiscard]] size_t count() const { return _marked.size(); }
+
+       private:
+        std::vector<uint8_t> _marked;
+        std::vector<uint32_t> _pages;
+    };
+}  // namespace game::snake
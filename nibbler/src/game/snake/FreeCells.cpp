@@ -0,0 +1,39 @@
+#include "FreeCells.h"
+
+namespace game::snake {
+    FreeCells::FreeCells(size_t capacity)
+        : _cells(capacity), _slots(capacity, NONE), _dirty_cells(capacity), _dirty_slots(capacity) {}
+
+    void FreeCells::insert(uint32_t cell) {
+        if (_slots[cell] != NONE) return;
+        _set_slot(cell, static_cast<uint32_t>(_size));
+        _set_cell(static_cast<uint32_t>(_size++), cell);
+    }
+
+    void FreeCells::erase(uint32_t cell) {
+        auto slot = _slots[cell];
+        if (slot == NONE) return;
+        auto last = _cells[--_size];
+        _set_cell(slot, last);
+        _set_slot(last, slot);
+        _set_slot(cell, NONE);
+    }
+
+    bool FreeCells::contains(uint32_t cell) const { return _slots[cell] != NONE; }
+
+    size_t FreeCells::size() const { return _size; }
+
+    bool FreeCells::empty() const { return _size == 0; }
+
+    uint32_t FreeCells::operator[](size_t i) const { return _cells[i]; }
+
+    void FreeCells::_set_cell(uint32_t slot, uint32_t cell) {
+        _cells[slot] = cell;
+        _dirty_cells.mark(slot);
+    }
+
+    void FreeCells::_set_slot(uint32_t cell, uint32_t slot) {
+        _slots[cell] = slot;
+        _dirty_slots.mark(cell);
+    }
+}  // namespace game::snake
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/snake/DirtyPages.h"
+
+namespace game::snake {
+    /**
+     * @brief Set of free (background) cell indices, with O(1) insert, erase and random access.
+     *
+     * The indices are stored densely, and each cell remembers its slot in the dense array, so that erase() can swap
+     * the last index into the hole. The order of the indices is therefore unspecified.
+     *
+     * Both arrays are allocated at full size and never move, and their writes are tracked page by page for History.
+     */
+    class FreeCells {
+        friend class History;
+
+       public:
+        /**
+         * @brief FreeCells constructor, all the memory is allocated up front.
+         * @param capacity The number of cells on the board.
+         */
+        explicit FreeCells(size_t capacity);
+
+        /** @brief Add a cell to the set, no-op if already present. */
+        void insert(uint32_t cell);
+        /** @brief Remove a cell from the set, no-op if not present. */
+        void erase(uint32_t cell);
+        [[nodiscard]] bool contains(uint32_t cell) const;
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] bool empty() const;
+        /** @return The i-th cell of the set, i must be lower than size(). */
+        [[nodiscard]] uint32_t operator[](size_t i) const;
+
+       private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        void _set_cell(uint32_t slot, uint32_t cell);
+        void _set_slot(uint32_t cell, uint32_t slot);
+
+        /** @brief The free cells, densely packed in the first _size elements */
+        std::vector<uint32_t> _cells;
+        size_t _size = 0;
+        /** @brief The slot of each cell in _cells, or NONE */
+        std::vector<uint32_t> _slots;
+        DirtyPages<uint32_t> _dirty_cells;
+        DirtyPages<uint32_t> _dirty_slots;
+    };
+}  // namespace game::snake
@@ -0,0 +1,193 @@
+#include "History.h"
+
+#include <algorithm>
+
+namespace game::snake {
+    template <class T>
+    size_t History::Flat<T>::page_size(uint32_t page) const {
+        return std::min(DirtyPages<T>::PAGE_SIZE, size - page * DirtyPages<T>::PAGE_SIZE);
+    }
+
+    template <class T>
+    T const *History::Flat<T>::read(uint32_t page) const {
+        return live + page * DirtyPages<T>::PAGE_SIZE;
+    }
+
+    template <class T>
+    void History::Flat<T>::write(uint32_t page, T const *content) {
+        std::copy_n(content, page_size(page), live + page * DirtyPages<T>::PAGE_SIZE);
+    }
+
+    size_t History::Tiles::page_size(uint32_t) const { return matrix->tile_cells(); }
+
+    Entity const *History::Tiles::read(uint32_t page) const { return matrix->tile(page); }
+
+    void History::Tiles::write(uint32_t page, Entity const *content) {
+        if (content)
+            std::copy_n(content, matrix->tile_cells(), matrix->allocate(page));
+        else
+            matrix->release(page);
+    }
+
+    template <class Source>
+    History::Track<Source>::Track(Source source, DirtyPages<T> &dirty)
+        : source(source), dirty(&dirty), shadow(dirty.count()) {
+        for (uint32_t page = 0; page < shadow.size(); ++page) shadow[page] = _copy(page);
+        dirty.clear();
+    }
+
+    template <class Source>
+    void History::Track<Source>::commit(std::vector<Image<T>> &undo) {
+        for (auto page : dirty->pages()) {
+            undo.push_back({.page = page, .content = std::move(shadow[page])});
+            shadow[page] = _copy(page);
+        }
+        dirty->clear();
+    }
+
+    template <class Source>
+    void History::Track<Source>::revert() {
+        for (auto page : dirty->pages()) _write(page, shadow[page]);
+        dirty->clear();
+    }
+
+    template <class Source>
+    void History::Track<Source>::restore(Image<T> const &image) {
+        _write(image.page, image.content);
+        shadow[image.page] = image.content;
+    }
+
+    template <class Source>
+    History::Page<typename Source::value_type> History::Track<Source>::_copy(uint32_t page) const {
+        auto const *begin = source.read(page);
+        if (!begin) return nullptr;
+        return std::make_shared<std::vector<T> const>(begin, begin + source.page_size(page));
+    }
+
+    template <class Source>
+    void History::Track<Source>::_write(uint32_t page, Page<T> const &content) {
+        source.write(page, content ? content->data() : nullptr);
+        restored.push_back(page);
+    }
+
+    History::History(Snake &snake, size_t depth, uint64_t tick)
+        : _snake(snake),
+          _board(Tiles{.matrix = &snake._board._matrix}, snake._board._dirty),
+          _snapshots(std::max<size_t>(depth, 1), Snapshot{.rng = snake._board._rng}),
+          _oldest(tick),
+          _latest(tick) {
+        if (snake._board._free) _track_free_cells();
+        _record(_at(tick));
+    }
+
+    void History::snapshot() {
+        if (_snake._player._moves - _at(_latest).moves > 1) throw exception::HistoryGapException();
+        if (++_latest - _oldest == _snapshots.size()) ++_oldest;
+
+        auto &snapshot = _at(_latest);
+        snapshot.board.clear();
+        snapshot.cells.clear();
+        snapshot.slots.clear();
+        _board.commit(snapshot.board);
+        if (_cells) {
+            _cells->commit(snapshot.cells);
+            _slots->commit(snapshot.slots);
+        } else if (_snake._board._free) {
+            // Created during this tick, its shadow is this snapshot
+            _track_free_cells();
+        }
+        _record(snapshot);
+    }
+
+    void History::rewind(uint64_t tick) {
+        if (tick < _oldest || tick > _latest) throw exception::HistoryRangeException();
+        auto pending = _snake._player._moves - _at(_latest).moves;
+        if (pending > 1) throw exception::HistoryGapException();
+
+        auto const &target = _at(tick);
+        auto &board = _snake._board;
+        // The index did not exist yet: drop it, it is rebuilt the same way when the board fills up again
+        if (!target.indexed) {
+            _cells.reset();
+            _slots.reset();
+            board._free.reset();
+        }
+
+        // Back to the latest snapshot, then one snapshot at a time
+        _board.restored.clear();
+        if (pending) _unstep(_at(_latest));
+        _board.revert();
+        if (_cells) {
+            _cells->revert();
+            _slots->revert();
+        }
+        for (; _latest > tick; --_latest) {
+            auto const &undone = _at(_latest);
+            _unstep(_at(_latest - 1));
+            for (auto const &image : undone.board) _board.restore(image);
+            if (!_cells) continue;
+            for (auto const &image : undone.cells) _cells->restore(image);
+            for (auto const &image : undone.slots) _slots->restore(image);
+        }
+        _sync_occupancy();
+
+        auto &player = _snake._player;
+        player._head_pos = target.head;
+        player._moves = target.moves;
+        board._rng = target.rng;
+        board._food = target.food;
+        board._background = target.background;
+        if (board._free) board._free->_size = target.free;
+        board._damage.mark_all();
+    }
+
+    uint64_t History::oldest() const { return _oldest; }
+
+    uint64_t History::latest() const { return _latest; }
+
+    void History::_track_free_cells() {
+        auto &free = *_snake._board._free;
+        _cells.emplace(Flat<uint32_t>{.live = free._cells.data(), .size = free._cells.size()}, free._dirty_cells);
+        _slots.emplace(Flat<uint32_t>{.live = free._slots.data(), .size = free._slots.size()}, free._dirty_slots);
+    }
+
+    void History::_record(Snapshot &snapshot) {
+        auto const &player = _snake._player;
+        auto const &board = _snake._board;
+        snapshot.head = player._head_pos;
+        snapshot.length = player._body.size();
+        snapshot.tail = player._body.empty() ? 0 : player._body.back();
+        snapshot.moves = player._moves;
+        snapshot.rng = board._rng;
+        snapshot.food = board._food;
+        snapshot.background = board._background;
+        snapshot.indexed = board._free != nullptr;
+        snapshot.free = board._free ? board._free->_size : 0;
+    }
+
+    void History::_unstep(Snapshot const &before) {
+        auto &body = _snake._player._body;
+        body.pop_front();
+        if (body.size() < before.length) body.push_back(before.tail);
+    }
+
+    void History::_sync_occupancy() {
+        auto &board = _snake._board;
+        auto const &matrix = board._matrix;
+        auto &pages = _board.restored;
+        std::sort(pages.begin(), pages.end());
+        pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+        for (auto page : pages) {
+            auto x0 = page % matrix.tiles_x() * Matrix<Entity>::TILE;
+            auto y0 = page / matrix.tiles_x() * Matrix<Entity>::TILE;
+            auto x1 = std::min(x0 + Matrix<Entity>::TILE, matrix.width);
+            auto y1 = std::min(y0 + Matrix<Entity>::TILE, matrix.height);
+            for (auto y = y0; y < y1; ++y) {
+                auto cells = matrix.segment(x0, y);
+                for (auto x = x0; x < x1; ++x) board._occupancy.set(x, y, blocks(cells[x - x0]));
+            }
+        }
+    }
+
+    History::Snapshot &History::_at(uint64_t tick) { return _snapshots[tick % _snapshots.size()]; }
+}  // namespace game::snake
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "game/snake/Snake.h"
+
+namespace game::snake {
+    /**
+     * @brief Bounded rewind buffer of a Snake, one snapshot per tick.
+     *
+     * The board (one page per Matrix tile), and the free-cell index that drives food placement, are split in
+     * DirtyPages pages. History keeps a shadow of every page as of the latest snapshot, as immutable pages shared
+     * between snapshots: a snapshot copies only the pages written since the previous one, and stores the pages they
+     * replace as its undo images. Tiles never written are not copied at all. The Player is recorded as a body delta
+     * (head, length and tail), since a tick only moves both ends of the body.
+     *
+     * Taking a snapshot and rewinding both cost O(changed pages), whatever the size of the board, the occupancy
+     * Bitboard being rebuilt from the restored pages only. A restored Snake continues exactly as the original would
+     * have, food placement included.
+     *
+     * snapshot() must be called after every Player step, and a Snake must not have more than one History.
+     */
+    class History {
+       public:
+        /**
+         * @brief History constructor, takes the first snapshot, copying the whole board once.
+         * @param snake The Snake to record, must outlive the History.
+         * @param depth Number of snapshots kept, the oldest ones are dropped first.
+         * @param tick Identifier of the first snapshot, the following ones are numbered consecutively.
+         */
+        History(Snake &snake, size_t depth, uint64_t tick = 0);
+
+        /**
+         * @brief Record the current state as the next tick.
+         * @throws exception::HistoryGapException if the Player moved more than once since the previous snapshot.
+         */
+        void snapshot();
+
+        /**
+         * @brief Restore the Snake as it was at a recorded tick, and forget the snapshots taken after it.
+         *
+         * The whole board is marked as damaged.
+         *
+         * @throws exception::HistoryRangeException if the tick is not held anymore, or not yet.
+         */
+        void rewind(uint64_t tick);
+
+        /** @return The oldest tick that can be restored. */
+        [[nodiscard]] uint64_t oldest() const;
+        /** @return The tick of the latest snapshot. */
+        [[nodiscard]] uint64_t latest() const;
+
+       private:
+        /** @brief Immutable content of a page, shared by the shadow and the snapshots. nullptr for a blank tile */
+        template <class T>
+        using Page = std::shared_ptr<std::vector<T> const>;
+
+        /** @brief Content of a page before a snapshot changed it */
+        template <class T>
+        struct Image {
+            uint32_t page;
+            Page<T> content;
+        };
+
+        /** @brief The pages of a plain array, that never moves */
+        template <class T>
+        struct Flat {
+            using value_type = T;
+
+            T *live;
+            size_t size;
+
+            [[nodiscard]] size_t page_size(uint32_t page) const;
+            [[nodiscard]] T const *read(uint32_t page) const;
+            void write(uint32_t page, T const *content);
+        };
+
+        /** @brief The pages of the board, its tiles */
+        struct Tiles {
+            using value_type = Entity;
+
+            Matrix<Entity> *matrix;
+
+            [[nodiscard]] size_t page_size(uint32_t page) const;
+            /** @return nullptr for a tile never written */
+            [[nodiscard]] Entity const *read(uint32_t page) const;
+            /** @brief nullptr releases the tile */
+            void write(uint32_t page, Entity const *content);
+        };
+
+        /** @brief A paged memory, its write tracking, and the pages of the latest snapshot */
+        template <class Source>
+        struct Track {
+            using T = typename Source::value_type;
+
+            Source source;
+            DirtyPages<T> *dirty;
+            std::vector<Page<T>> shadow;
+            /** @brief Pages written back by revert() and restore(), possibly more than once */
+            std::vector<uint32_t> restored;
+
+            Track(Source source, DirtyPages<T> &dirty);
+            /** @brief Copy the dirty pages into the shadow, the pages they replace go to undo. */
+            void commit(std::vector<Image<T>> &undo);
+            /** @brief Write back the shadow of the dirty pages, i.e. undo the changes since the latest snapshot. */
+            void revert();
+            /** @brief Write back a page image, into both the live memory and the shadow. */
+            void restore(Image<T> const &image);
+
+           private:
+            Page<T> _copy(uint32_t page) const;
+            void _write(uint32_t page, Page<T> const &content);
+        };
+
+        struct Snapshot {
+            Rng rng;
+            std::pair<size_t, size_t> head{};
+            size_t length = 0;
+            uint32_t tail = 0;
+            uint64_t moves = 0;
+            uint32_t food = 0;
+            size_t background = 0;
+            /** @brief The board had a free-cell index, and its size */
+            bool indexed = false;
+            size_t free = 0;
+            /** @brief Undo images, bringing the pages back to the previous snapshot */
+            std::vector<Image<Entity>> board{};
+            std::vector<Image<uint32_t>> cells{};
+            std::vector<Image<uint32_t>> slots{};
+        };
+
+        /** @brief Start tracking the free-cell index, once the Board created it */
+        void _track_free_cells();
+        void _record(Snapshot &snapshot);
+        /** @brief Undo the body changes of one tick, given the state before it */
+        void _unstep(Snapshot const &before);
+        /** @brief Rebuild the occupancy of the tiles written back */
+        void _sync_occupancy();
+        Snapshot &_at(uint64_t tick);
+
+        Snake &_snake;
+        Track<Tiles> _board;
+        /** @brief Only once the Board has a free-cell index */
+        std::optional<Track<Flat<uint32_t>>> _cells;
+        std::optional<Track<Flat<uint32_t>>> _slots;
+        /** @brief Ring of snapshots, the Images are reused to avoid allocations */
+        std::vector<Snapshot> _snapshots;
+        uint64_t _oldest;
+        uint64_t _latest;
+    };
+}  // namespace game::snake
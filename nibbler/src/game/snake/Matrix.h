@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+namespace game::snake {
+    /**
+     * @brief 2D grid of cells, stored as square tiles that are only allocated once written.
+     *
+     * Every cell starts with the fill value, and a tile that was never written is not allocated at all: it reads
+     * from a tile of fill values, shared by every Matrix of T() cells. The memory of the cells of a huge, mostly
+     * empty board is therefore proportional to the area that was actually written, not that of the Board around
+     * them (see Board).
+     *
+     * Tiles are TILE x TILE cells, or as wide and high as the board if it is smaller: a board that fits in a single
+     * tile is stored flat, in exactly width * height cells. Inside a tile, cells are row-major, so segment() gives the
+     * contiguous cells of a row up to the tile's right edge, and a tile is the natural unit to copy (see History).
+     *
+     * Cells are identified by their flat index x + y * width, whatever the storage.
+     *
+     * @tparam T Trivially copyable cell type.
+     */
+    template <class T>
+    class Matrix {
+       public:
+        static constexpr size_t TILE = 64;
+        static constexpr size_t TILE_CELLS = TILE * TILE;
+
+        Matrix(size_t x, size_t y, T value = T())
+            : width(x),
+              height(y),
+              _tile_width(std::min(x, TILE)),
+              _tile_cells(_tile_width * std::min(y, TILE)),
+              _tiles_x((x + TILE - 1) / TILE),
+              _tiles((x + TILE - 1) / TILE * ((y + TILE - 1) / TILE)),
+              _fill(value),
+              _blank(BLANK) {
+            if (value != T()) {
+                _own_blank = std::make_unique<T[]>(_tile_cells);
+                std::fill_n(_own_blank.get(), _tile_cells, value);
+                _blank = _own_blank.get();
+            }
+            SPDLOG_DEBUG("width {}, height {}, tiles {} of {} cells", width, height, _tiles.size(), _tile_cells);
+        }
+
+        T operator()(size_t x, size_t y) const {
+            auto const &tile = _tiles[tile_of(x, y)];
+            return tile ? tile[_offset(x, y)] : _fill;
+        }
+        T operator[](size_t index) const { return (*this)(index % width, index / width); }
+
+        /** @brief Write a cell, allocating its tile the first time. */
+        void set(size_t x, size_t y, T value) { allocate(tile_of(x, y))[_offset(x, y)] = value; }
+
+        /** @return The contiguous cells from (x, y) to the right edge of its tile, or of the board. */
+        std::span<T const> segment(size_t x, size_t y) const {
+            auto const &tile = _tiles[tile_of(x, y)];
+            auto count = std::min(TILE - x % TILE, width - x);
+            return {(tile ? tile.get() : _blank) + _offset(x, y), count};
+        }
+
+        /** @brief Flat index of the cell at (x, y) */
+        [[nodiscard]] size_t index(size_t x, size_t y) const { return x + (y * width); }
+        [[nodiscard]] size_t size() const { return width * height; }
+
+        /** @brief Index of the tile holding (x, y), tiles are row-major too */
+        [[nodiscard]] size_t tile_of(size_t x, size_t y) const { return (y / TILE) * _tiles_x + x / TILE; }
+        [[nodiscard]] size_t tiles() const { return _tiles.size(); }
+        [[nodiscard]] size_t tiles_x() const { return _tiles_x; }
+        /** @brief Number of cells of every tile, at most TILE_CELLS */
+        [[nodiscard]] size_t tile_cells() const { return _tile_cells; }
+        /** @return The tile_cells() cells of a tile, nullptr if it was never written. */
+        [[nodiscard]] T const *tile(size_t index) const { return _tiles[index].get(); }
+        /** @return The cells of a tile, allocated and filled with the fill value if needed. */
+        T *allocate(size_t index) {
+            auto &tile = _tiles[index];
+            if (!tile) {
+                tile = std::make_unique_for_overwrite<T[]>(_tile_cells);
+                std::copy_n(_blank, _tile_cells, tile.get());
+            }
+            return tile.get();
+        }
+        /** @brief Free a tile, all its cells read as the fill value again. */
+        void release(size_t index) { _tiles[index].reset(); }
+
+       public:
+        const size_t width;
+        const size_t height;
+
+       private:
+        [[nodiscard]] size_t _offset(size_t x, size_t y) const { return (y % TILE) * _tile_width + x % TILE; }
+
+        /** @brief The tile of T() values, read-only and shared by every Matrix of T */
+        static constexpr T BLANK[TILE_CELLS]{};
+
+        size_t _tile_width;
+        size_t _tile_cells;
+        size_t _tiles_x;
+        std::vector<std::unique_ptr<T[]>> _tiles;
+        T _fill;
+        /** @brief A tile of fill values, read in place of the tiles not allocated: BLANK, or _own_blank */
+        T const *_blank;
+        /** @brief Only for a fill value other than T() */
+        std::unique_ptr<T[]> _own_blank;
+    };
+}  // namespace game::snake
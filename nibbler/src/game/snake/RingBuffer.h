@@ -0,0 +1,66 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace game::snake {
+    /**
+     * @brief Growable circular buffer with O(1) push and pop at both ends.
+     *
+     * The capacity is always a power of two, so wrapping around is a mask instead of a modulo. When full, a push
+     * doubles the capacity and unrolls the elements into the new storage, which is amortized O(1).
+     *
+     * @tparam T Trivially copyable element type.
+     */
+    template <class T>
+    class RingBuffer {
+       public:
+        /** @param capacity Initial capacity, rounded up to a power of two. */
+        explicit RingBuffer(size_t capacity = 16) : _buffer(std::bit_ceil(capacity < 2 ? 2 : capacity)) {}
+
+        void push_front(T value) {
+            if (_size == _buffer.size()) _grow();
+            _head = (_head - 1) & _mask();
+            _buffer[_head] = value;
+            ++_size;
+        }
+
+        void pop_back() { --_size; }
+
+        void push_back(T value) {
+            if (_size == _buffer.size()) _grow();
+            _buffer[(_head + _size) & _mask()] = value;
+            ++_size;
+        }
+
+        void pop_front() {
+            _head = (_head + 1) & _mask();
+            --_size;
+        }
+
+        /** @return The i-th element, front() being 0. */
+        T operator[](size_t i) const { return _buffer[(_head + i) & _mask()]; }
+        T front() const { return _buffer[_head]; }
+        T back() const { return (*this)[_size - 1]; }
+
+        [[nodiscard]] size_t size() const { return _size; }
+        [[nodiscard]] bool empty() const { return _size == 0; }
+        [[nodiscard]] size_t capacity() const { return _buffer.size(); }
+
+       private:
+        [[nodiscard]] size_t _mask() const { return _buffer.size() - 1; }
+
+        void _grow() {
+            std::vector<T> buffer(_buffer.size() * 2);
+            for (size_t i = 0; i < _size; ++i) buffer[i] = (*this)[i];
+            _buffer.swap(buffer);
+            _head = 0;
+        }
+
+       private:
+        std::vector<T> _buffer;
+        size_t _head = 0;
+        size_t _size = 0;
+    };
+}  // namespace game::snake
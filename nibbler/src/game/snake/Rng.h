@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+namespace game::snake {
+    using Seed = uint64_t;
+
+    /** @brief A fresh Seed from the OS, for games that do not need to be reproduced. */
+    inline Seed random_seed() {
+        std::random_device device;
+        return (Seed(device()) << 32) | device();
+    }
+
+    /**
+     * @brief Small and fast PRNG (xoshiro128**), one per game.
+     *
+     * The whole sequence is determined by the Seed, on every platform, which is what makes replays possible. The
+     * state is expanded from the Seed with splitmix64, so that close seeds still give unrelated sequences.
+     */
+    class Rng {
+       public:
+        explicit Rng(Seed seed) {
+            for (size_t i = 0; i < 4; i += 2) {
+                auto z = (seed += 0x9E3779B97F4A7C15);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+                z ^= z >> 31;
+                _s[i] = static_cast<uint32_t>(z);
+                _s[i + 1] = static_cast<uint32_t>(z >> 32);
+            }
+        }
+
+        uint32_t operator()() {
+            auto result = rotl(_s[1] * 5, 7) * 9;
+            auto t = _s[1] << 9;
+            _s[2] ^= _s[0];
+            _s[3] ^= _s[1];
+            _s[1] ^= _s[2];
+            _s[0] ^= _s[3];
+            _s[2] ^= t;
+            _s[3] = rotl(_s[3], 11);
+            return result;
+        }
+
+        /** @brief Uniform in [0, bound), without division in the common case (Lemire's method). */
+        uint32_t below(uint32_t bound) {
+            auto m = uint64_t((*this)()) * bound;
+            if (auto low = static_cast<uint32_t>(m); low < bound) {
+                auto threshold = -bound % bound;
+                while (low < threshold) {
+                    m = uint64_t((*this)()) * bound;
+                    low = static_cast<uint32_t>(m);
+                }
+            }
+            return static_cast<uint32_t>(m >> 32);
+        }
+
+       private:
+        static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+        uint32_t _s[4];
+    };
+}  // namespace game::snake
@@ -1,79 +1,119 @@
 #include "Snake.h"
 
-#include <random>
-#include <sstream>
-
 #include "literals.h"
 
 namespace game::snake {
     namespace {
-        void init_map(Matrix<Entity> &m) {
-            const size_t lt_edge = 0;
-            const size_t rt_edge = m.height - 1;
-            const size_t top_edge = 0;
-            const size_t bot_edge = m.width - 1;
-
-            for (size_t x = 0; x < m.width; ++x) {
-                for (size_t y = 0; y < m.height; ++y) {
-                    if (y == lt_edge || y == rt_edge || x == top_edge || x == bot_edge) {
-                        m(x, y) = snake::Entity::Wall;
-                    } else {
-                        m(x, y) = snake::Entity::Background;
-                    }
-                }
+        /** @brief The board width, once the board size is checked, before anything is allocated or written */
+        size_t checked_width(size_t x, size_t y) {
+            static_assert(literals::BOARD_MAXIMUM_CELLS <= UINT32_MAX, "Every cell must have a 32-bit index");
+            if (x < literals::BOARD_MINIMUM_WIDTH || y < literals::BOARD_MINIMUM_HEIGHT) {
+                throw exception::SnakeSmallMatrixException();
             }
+            if (x > literals::BOARD_MAXIMUM_CELLS / y) throw exception::SnakeLargeMatrixException();
+            return x;
         }
 
-        template <typename T>
-        T random(T range_from, T range_to) {
-            std::random_device rand_dev;
-            std::mt19937 generator(rand_dev());
-            std::uniform_int_distribution<T> distr(range_from, range_to);
-            return distr(generator);
+        /** @brief Surround the board with walls, row by row. The inside is left to the fill value (Background). */
+        void init_map(Matrix<Entity> &m, Bitboard &occupancy) {
+            auto wall = [&](size_t x, size_t y) {
+                m.set(x, y, Entity::Wall);
+                occupancy.set(x, y, true);
+            };
+            for (size_t x = 0; x < m.width; ++x) wall(x, 0);
+            for (size_t y = 1; y + 1 < m.height; ++y) {
+                wall(0, y);
+                wall(m.width - 1, y);
+            }
+            for (size_t x = 0; x < m.width; ++x) wall(x, m.height - 1);
         }
+    }  // namespace
 
-        Entity &find_empty_entity(Matrix<Entity> &m) {
-            std::vector<Entity *> bg_entities;
-            bg_entities.reserve(m.height * m.height);
+    Board::Board(size_t x, size_t y, Seed seed)
+        : _matrix(checked_width(x, y), y, Entity::Background),
+          _dirty(_matrix.tiles() * Matrix<Entity>::TILE_CELLS),
+          _occupancy(x, y),
+          _rng(seed) {
+        static_assert(DirtyPages<Entity>::PAGE_SIZE == Matrix<Entity>::TILE_CELLS, "a History page must be a tile");
+        init_map(_matrix, _occupancy);
+        _background = (x - std::min<size_t>(x, 2)) * (y - std::min<size_t>(y, 2));
+        _damage.mark_all();
+    }
 
-            for (auto &e : m) {
-                if (e == Entity::Background) {
-                    bg_entities.push_back(&e);
-                }
-            }
+    void Board::set(size_t x, size_t y, Entity e) {
+        auto previous = _matrix(x, y);
+        _matrix.set(x, y, e);
+        _damage.mark(x, y);
+        _dirty.mark_page(_matrix.tile_of(x, y));
+        _occupancy.set(x, y, blocks(e));
+        _background += (e == Entity::Background) - (previous == Entity::Background);
+        if (!_free) return;
+        auto index = static_cast<uint32_t>(_matrix.index(x, y));
+        if (e == Entity::Background)
+            _free->insert(index);
+        else
+            _free->erase(index);
+    }
 
-            if (bg_entities.empty()) {
-                throw exception::SnakeNoEmptySpaceException();
-            }
-            return *bg_entities[random<size_t>(0, bg_entities.size())];
+    bool Board::spawn_food() {
+        if (!_background) return false;
+        uint32_t index;
+        if (!_free && _background * 2 >= _matrix.size()) {
+            do {
+                index = _rng.below(static_cast<uint32_t>(_matrix.size()));
+            } while (_matrix[index] != Entity::Background);
+        } else {
+            if (!_free) _index_free_cells();
+            index = (*_free)[_rng.below(static_cast<uint32_t>(_free->size()))];
         }
+        _food = index;
+        set(index % _matrix.width, index / _matrix.width, Entity::Food);
+        return true;
+    }
 
-        void spawn_food(Matrix<Entity> &m) { find_empty_entity(m) = Entity::Food; }
-
-    }  // namespace
+    void Board::_index_free_cells() {
+        _free = std::make_unique<FreeCells>(_matrix.size());
+        for (size_t y = 0; y < _matrix.height; ++y) {
+            for (size_t x = 0; x < _matrix.width;) {
+                auto cells = _matrix.segment(x, y);
+                for (auto e : cells) {
+                    if (e == Entity::Background) _free->insert(static_cast<uint32_t>(_matrix.index(x, y)));
+                    ++x;
+                }
+            }
+        }
+    }
 
-    Player::Player(Matrix<Entity> &matrix) : _m(matrix) { _body.reserve(literals::PLAYER_INITIAL_SIZE - 1); }
+    Player::Player(Board &board) : _body(literals::PLAYER_INITIAL_SIZE), _board(board) {}
 
     void Player::spawn() {
-        if (_m.width < literals::BOARD_MINIMUM_WIDTH || _m.height < literals::BOARD_MINIMUM_HEIGHT) {
+        if (_board.width() < literals::BOARD_MINIMUM_WIDTH || _board.height() < literals::BOARD_MINIMUM_HEIGHT) {
             throw exception::SnakeSmallMatrixException();
         }
 
-        auto x = _m.width / 2;
-        auto y = _m.height / 2;
+        auto x = _board.width() / 2;
+        auto y = _board.height() / 2;
 
         _head_pos = std::make_pair(x, y);
-        _m(x, y) = Entity::Head;
+        _board.set(x, y, Entity::Head);
 
-        for (size_t i = 1; i < literals::PLAYER_INITIAL_SIZE; i++) {
-            _m(x, y - i) = Entity::Body;
-            _body.push_back(&_m(x, y - i));
+        for (size_t i = literals::PLAYER_INITIAL_SIZE - 1; i > 0; i--) {
+            _board.set(x, y - i, Entity::Body);
+            _body.push_front(static_cast<uint32_t>(_board.matrix().index(x, y - i)));
         }
     }
+
     void Player::move(Orientation o) {
+        if (step(o) == Outcome::DIED) {
+            throw exception::PlayerHitException();
+        }
+    }
+
+    Outcome Player::step(Orientation o) {
         decltype(_head_pos) next_pos;
 
         const auto [curr_x, curr_y] = _head_pos;
+        ++_moves;
         switch (o) {
             case Orientation::NORTH: next_pos = std::make_pair(curr_x, curr_y - 1); break;
             case Orientation::SOUTH: next_pos = std::make_pair(curr_x, curr_y + 1); break;
@@ -83,63 +123,40 @@ namespace game::snake {
 
         const auto [next_x, next_y] = next_pos;
         auto move_head = [&, this] {
-            _m(curr_x, curr_y) = Entity::Body;
-            _m(next_x, next_y) = Entity::Head;
-            _body.insert(_body.begin(), &_m(curr_x, curr_y));
+            _board.set(curr_x, curr_y, Entity::Body);
+            _board.set(next_x, next_y, Entity::Head);
+            _body.push_front(static_cast<uint32_t>(_board.matrix().index(curr_x, curr_y)));
             _head_pos = next_pos;
         };
 
         auto pop_tail = [&, this] {
-            *_body.back() = Entity::Background;
+            auto tail = _body.back();
+            _board.set(tail % _board.width(), tail / _board.width(), Entity::Background);
             _body.pop_back();
         };
 
-        switch (_m(next_x, next_y)) {
+        switch (_board(next_x, next_y)) {
             case Entity::Background:
                 pop_tail();
                 move_head();
-                break;
+                return Outcome::MOVED;
             case Entity::Food:
                 move_head();
-                spawn_food(_m);
-                break;
+                return _board.spawn_food() ? Outcome::ATE : Outcome::WON;
             case Entity::Wall: [[fallthrough]];
             case Entity::Head: [[fallthrough]];
-            case Entity::Body:
-                pop_tail();
-                move_head();
-                throw exception::PlayerHitException();
+            case Entity::Body: break;
         }
+        pop_tail();
+        move_head();
+        return Outcome::DIED;
     }
 
-    void Snake::_debug() const {
-        std::stringstream ss;
-        for (size_t y = 0; y < _matrix.height; ++y) {
-            for (size_t x = 0; x < _matrix.width; ++x) {
-                Entity item = _matrix(x, y);
-                switch (item) {
-                    case Entity::Background: ss << "  "; break;
-                    case Entity::Wall: ss << "▓ "; break;
-                    case Entity::Head: ss << "@ "; break;
-                    case Entity::Body: ss << "* "; break;
-                    case Entity::Food: ss << ". "; break;
-                }
-            }
-            ss << '\n';
-        }
-        std::cout << ss.str();
-    }
-
-    Snake::Snake(size_t x, size_t y) : _matrix(x, y, Entity::Background), _player(_matrix) {
-        if (x < literals::BOARD_MINIMUM_WIDTH || y < literals::BOARD_MINIMUM_HEIGHT) {
-            throw exception::SnakeSmallMatrixException();
-        }
-
-        init_map(_matrix);
+    Snake::Snake(size_t x, size_t y, Seed seed) : _board(x, y, seed), _player(_board) {
         _player.spawn();
-        spawn_food(_matrix);
-
-        _debug();
+        if (!_board.spawn_food()) {
+            throw exception::SnakeNoEmptySpaceException();
+        }
     }
 
 }  // namespace game::snake
@@ -1,75 +1,134 @@
 #pragma once
 
-#include <iostream>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "game/snake/Bitboard.h"
+#include "game/snake/Damage.h"
+#include "game/snake/DirtyPages.h"
+#include "game/snake/FreeCells.h"
+#include "game/snake/Matrix.h"
+#include "game/snake/RingBuffer.h"
+#include "game/snake/Rng.h"
 #include "game/snake/exception.h"
-#include "plugin/IPlugin.h"
 #include "spdlog/spdlog.h"
 
 namespace game::snake {
-    using interface::ARGB;
-    static_assert(sizeof(ARGB) == 4, "ARGB must have 4 bytes");
-
-    constexpr ARGB BLACK = 0x00000000;
-    constexpr ARGB WHITE = 0x00FFFFFF;
-    constexpr ARGB RED = 0x00FF0000;
-    constexpr ARGB YELLOW = 0x00FCBA03;
-    constexpr ARGB GREEN = 0x000000FF;
-
     enum class Orientation { NORTH, SOUTH, EAST, WEST };
-    enum class Entity : ARGB {
-        Background = BLACK,
-        Wall = WHITE,
-        Head = RED,
-        Body = YELLOW,
-        Food = GREEN,
+    /** @brief Result of moving the Player by one cell. */
+    enum class Outcome {
+        MOVED,  ///< Moved into an empty cell
+        ATE,    ///< Ate the food, a new one was spawned
+        DIED,   ///< Hit a wall or itself
+        WON     ///< Ate the food, and there is no free cell left for a new one
     };
+    /** @brief Content of a board cell, one byte per cell. Colours are given by render::Palette. */
+    enum class Entity : uint8_t {
+        Background,
+        Wall,
+        Head,
+        Body,
+        Food,
+    };
+    constexpr size_t ENTITY_COUNT = 5;
+    static_assert(sizeof(Entity) == 1, "Entity must fit in a byte");
 
-    template <class T>
-    class Matrix {
-       public:
-        Matrix(size_t x, size_t y, T value = T()) : width(x), height(y), _buffer(x * y, value) {
-            SPDLOG_DEBUG("width {}, height {}, size {}", width, height, _buffer.size());
-        }
-
-        T &operator()(size_t x, size_t y) { return _buffer[x + (y * width)]; }
-        T const &operator()(size_t x, size_t y) const { return _buffer[x + (y * width)]; }
+    /** @return true if moving into the Entity kills the Player. */
+    constexpr bool blocks(Entity e) { return e == Entity::Wall || e == Entity::Head || e == Entity::Body; }
 
-        std::vector<T>::iterator begin() { return _buffer.begin(); }
-        //        std::vector<T>::const_iterator cbegin() { return _buffer.cbegin(); }
-        std::vector<T>::iterator end() { return _buffer.end(); }
-        //        std::vector<T>::const_iterator cend() { return _buffer.cend(); }
+    /**
+     * @brief The Snake board: the cells, plus the bookkeeping that must follow every cell write.
+     *
+     * Every write goes through set(), which keeps the Damage, the occupancy Bitboard and the free-cell index in sync
+     * with the Matrix, so that spawn_food() can pick a free cell in O(1) without scanning the board.
+     *
+     * Only the walls are written at construction, the rest of the board is left to the Matrix fill value. While at
+     * least half the board is Background, food is placed by drawing random cells until a free one comes up (less
+     * than two draws on average), and the free-cell index, whose memory is proportional to the whole board, does not
+     * exist. It is built once, the first time the board is more than half full.
+     *
+     * Only the Matrix is sparse: the occupancy Bitboard (one bit per cell) and the DirtyPages marks (five bytes per
+     * tile) are allocated for the whole board, e.g. 12.6 MB and 0.12 MB for 10000x10000.
+     */
+    class Board {
+        friend class History;
 
        public:
-        const size_t width;
-        const size_t height;
+        /**
+         * @throws exception::SnakeSmallMatrixException below the minimum board size, and
+         * exception::SnakeLargeMatrixException above literals::BOARD_MAXIMUM_CELLS, before allocating anything.
+         */
+        Board(size_t x, size_t y, Seed seed);
+
+        Entity operator()(size_t x, size_t y) const { return _matrix(x, y); }
+        /** @brief Write a cell, recording it as damaged and updating the free-cell index. */
+        void set(size_t x, size_t y, Entity e);
+        /** @brief Place a Food on a random free cell, returns false if there is none. */
+        bool spawn_food();
+
+        [[nodiscard]] Matrix<Entity> const &matrix() const { return _matrix; }
+        /** @brief The cells that block the Player, for reachability queries */
+        [[nodiscard]] Bitboard const &occupancy() const { return _occupancy; }
+        /** @brief Index of the cell holding the Food, stale once the board is full */
+        [[nodiscard]] uint32_t food() const { return _food; }
+        [[nodiscard]] Damage &damage() { return _damage; }
+        [[nodiscard]] size_t width() const { return _matrix.width; }
+        [[nodiscard]] size_t height() const { return _matrix.height; }
 
        private:
-        std::vector<T> _buffer;
+        void _index_free_cells();
+
+        Matrix<Entity> _matrix;
+        /** @brief Cells changed since the last rendered frame */
+        Damage _damage;
+        /** @brief Tiles of _matrix changed since the last History snapshot */
+        DirtyPages<Entity> _dirty;
+        Bitboard _occupancy;
+        /** @brief Number of Background cells */
+        size_t _background = 0;
+        /** @brief Background cells, i.e. where food can spawn. Only once the board is more than half full */
+        std::unique_ptr<FreeCells> _free;
+        Rng _rng;
+        uint32_t _food = 0;
     };
 
     class Player {
+        friend class History;
+
        public:
-        explicit Player(Matrix<Entity> &matrix);
+        explicit Player(Board &board);
         void spawn();
+        /** @brief Move by one cell, throws PlayerHitException if the Player died. */
         void move(Orientation o);
+        /** @brief Move by one cell, never throws, logs or allocates (besides growing the body). */
+        Outcome step(Orientation o);
+
+        [[nodiscard]] std::pair<size_t, size_t> head() const { return _head_pos; }
+        [[nodiscard]] RingBuffer<uint32_t> const &body() const { return _body; }
 
        private:
-        std::vector<Entity *> _body{};
+        /** @brief Cell indices of the body, front() is the neck and back() the tail */
+        RingBuffer<uint32_t> _body;
         std::pair<size_t, size_t> _head_pos;
-        Matrix<Entity> &_m;
+        /** @brief Number of step() performed */
+        uint64_t _moves = 0;
+        Board &_board;
     };
 
     class Snake {
        public:
-        Snake(size_t x, size_t y);
+        /**
+         * @brief Snake constructor.
+         * @param x Board width.
+         * @param y Board height.
+         * @param seed Seed of the food placement, the same seed and inputs always play the same game.
+         * @throws exception::SnakeSmallMatrixException, exception::SnakeLargeMatrixException, see Board::Board().
+         */
+        Snake(size_t x, size_t y, Seed seed = random_seed());
 
-       private:
        public:
-        void _debug() const;
-
-        Matrix<Entity> _matrix;
+        Board _board;
         Player _player;
     };
 }  // namespace game::snake
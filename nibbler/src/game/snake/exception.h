@@ -7,6 +7,10 @@ namespace game::snake::exception {
         [[nodiscard]] const char *what() const noexcept final { return "Snake Game size must be at least 10x10"; }
     };
 
+    struct SnakeLargeMatrixException : public std::exception {
+        [[nodiscard]] const char *what() const noexcept final { return "Snake Game size must be at most 2^30 cells"; }
+    };
+
     struct SnakeNoEmptySpaceException : public std::exception {
         [[nodiscard]] const char *what() const noexcept final { return "Snake Game has no empty space left!"; }
     };
@@ -14,4 +18,12 @@ namespace game::snake::exception {
         [[nodiscard]] const char *what() const noexcept final { return "Player hit something!"; }
     };
 
+    struct HistoryGapException : public std::exception {
+        [[nodiscard]] const char *what() const noexcept final { return "History must snapshot every Player step"; }
+    };
+
+    struct HistoryRangeException : public std::exception {
+        [[nodiscard]] const char *what() const noexcept final { return "History does not hold the requested tick"; }
+    };
+
 }  // namespace game::snake::exception
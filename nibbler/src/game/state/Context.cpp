@@ -1,15 +1,44 @@
 #include "Context.h"
 
+#include <utility>
+
 #include "game/Config.h"
 #include "game/state/Event.h"
-#include "game/state/impl/MainMenuState.h"
-#include "game/state/impl/PlayingState.h"
 #include "spdlog/spdlog.h"
 
 namespace game::state {
-    Context::Context(game::config::Config& c) : _config(c) { _change_state<impl::MainMenuState>(); }
-    void Context::handle_event(Event event) { _state->handle_event(event); }
+    Context::Context(game::config::Config& c, plugin::PluginSwitcher& plugins) : _config(c), _plugins(plugins) {
+        _change_state<impl::MainMenuState>();
+        _apply_transitions();
+    }
+
+    void Context::handle_event(TimedEvent event) {
+        std::visit(
+            [event](auto& state) {
+                using T = std::decay_t<decltype(state)>;
+                if constexpr (!std::is_same_v<T, std::monostate>) {
+                    if constexpr (!T::EVENTS.empty()) {
+                        if (T::EVENTS.contains(event.event)) state.handle_event(event);
+                    }
+                }
+            },
+            _states[_current]);
+        try {
+            _apply_transitions();
+        } catch (std::exception const& e) {
+            SPDLOG_ERROR("State transition failed, staying in the current State: {}", e.what());
+            _pending = nullptr;  // requested by the State that failed to build
+        }
+    }
+
+    void Context::_apply_transitions() {
+        while (_pending) {
+            (this->*std::exchange(_pending, nullptr))();
+        }
+    }
+
     State::State(game::state::Context& context) : _context(context) {}
     config::Config const& State::config() const { return _context._config; }
+    plugin::PluginSwitcher& State::plugins() { return _context._plugins; }
 
 }  // namespace game::state
@@ -1,15 +1,29 @@
 #pragma once
 
-#include <typeindex>
-#include <unordered_map>
+#include <array>
+#include <functional>
+#include <typeinfo>
+#include <variant>
+#include <vector>
 
 #include "game/Config.h"
 #include "game/plugin/Plugin.h"
 #include "game/state/Event.h"
+#include "game/state/State.h"
+#include "game/state/impl/ExitState.h"
+#include "game/state/impl/MainMenuState.h"
+#include "game/state/impl/PlayingState.h"
 #include "spdlog/spdlog.h"
 
 namespace game::state {
-    class State;
+    /** @brief Union of the Events wanted by every State of a Context States variant. */
+    template <class V>
+    struct events_of;
+    template <class... Ts>
+    struct events_of<std::variant<std::monostate, Ts...>> {
+        static constexpr EventSet value = (Ts::EVENTS | ...);
+    };
+
     class Context {
         /**
          * @brief So that State can request Context to change the current state.
@@ -17,76 +31,101 @@ namespace game::state {
         friend class State;
 
         using Callback = std::function<void()>;
+        /** @brief Every State the Context can be in, std::monostate only until the first transition. */
+        using States = std::variant<std::monostate, impl::MainMenuState, impl::PlayingState, impl::ExitState>;
+        /** @brief Position of T in States, resolved at compile time. */
+        template <class T, class V = States>
+        struct index_of;
+        template <class T, class... Ts>
+        struct index_of<T, std::variant<Ts...>> {
+            static constexpr size_t value = [] {
+                constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+                for (size_t i = 0; i < sizeof...(Ts); ++i)
+                    if (matches[i]) return i;
+                return sizeof...(Ts);
+            }();
+            static_assert(value < sizeof...(Ts), "T is not one of the Context States");
+        };
 
        public:
         /**
          * @brief Context Constructor.
+         * @param conf The game configuration.
+         * @param plugins The PluginSwitcher used by the States to display the game.
          */
-        Context(config::Config& conf);
+        Context(config::Config& conf, plugin::PluginSwitcher& plugins);
         ~Context() = default;
 
+        /** @brief Every Event at least one State is interested in */
+        static constexpr EventSet EVENTS = events_of<States>::value;
+
         /**
-         * @brief Deploy event to current State.
+         * @brief Deploy event to current State, if it is interested in it.
          * @param event Event to be deployed.
          */
-        void handle_event(Event event);
+        void handle_event(TimedEvent event);
 
         /**
          * @brief Subscribes a callback to be called when the State changes to the specified T State.
-         * @tparam T Concrete state to subscribe to. T must derive from State.
+         * @tparam T Concrete state to subscribe to. T must be one of the Context States.
          * @param cb Callback to be called when the context changes to a state of type T.
-         * @throws std::invalid_argument if T does not derive from State.
          */
         template <class T>
         void subscribe(Callback&& cb);
 
        private:
         /**
-         * @brief Generic function responsible for State transitions.
+         * @brief Request a State transition, applied by _apply_transitions().
          * This functions should only be used by State object, hence the friend class State.
          * @tparam T State to be changed to.
          */
         template <class T>
         void _change_state();
 
-       private:
-        config::Config& _config;
-        std::unique_ptr<State> _state;
-        std::unordered_map<std::string_view, std::vector<Callback>> subs;
-    };
-
-    class State {
-       public:
-        explicit State(Context& context);
-        virtual ~State() = default;
-        virtual void handle_event(Event event) = 0;
-
-       protected:
         /**
-         * @brief Friendship is not transitive (a friend of your friend is not your friend).
-         * @tparam T State to be changed to.
+         * @brief Build the T State, then replace the current one with it and notify its subscribers.
+         *
+         * Strong guarantee: the T State is built in the spare slot of _states, so if its constructor throws, the
+         * current State is left untouched and stays current.
          */
         template <class T>
-        void context_change_state();
+        void _enter();
 
-        config::Config const& config() const;
+        /** @brief Apply the pending transitions, if any. A transition that throws is dropped. */
+        void _apply_transitions();
 
-        Context& _context;
+       private:
+        config::Config& _config;
+        plugin::PluginSwitcher& _plugins;
+        /** @brief The current State, and the spare slot the next one is built in */
+        std::array<States, 2> _states;
+        size_t _current = 0;
+        /** @brief The pending transition, nullptr if none */
+        void (Context::*_pending)() = nullptr;
+        /** @brief Subscribers, indexed by the position of their State in States */
+        std::array<std::vector<Callback>, std::variant_size_v<States>> _subs;
     };
 
     template <class T>
     void Context::subscribe(Callback&& cb) {
         static_assert(std::is_base_of_v<State, T>, "T must derive from State");
         SPDLOG_DEBUG("Callback 0x{:x} subscribed to State transition {}", (std::uintptr_t)&cb, typeid(T).name());
-        subs[typeid(T).name()].push_back(cb);
+        _subs[index_of<T>::value].push_back(cb);
     }
 
     template <class T>
     void Context::_change_state() {
         static_assert(std::is_base_of_v<State, T>, "T must derive from State");
+        _pending = &Context::_enter<T>;
+    }
+
+    template <class T>
+    void Context::_enter() {
         SPDLOG_DEBUG("Changing State({})", typeid(T).name());
-        _state = std::make_unique<T>(*this);
-        for (auto& cb : subs[typeid(T).name()]) {
+        _states[_current ^ 1].template emplace<T>(*this);
+        _states[_current].template emplace<std::monostate>();
+        _current ^= 1;
+        for (auto& cb : _subs[index_of<T>::value]) {
             SPDLOG_DEBUG("Notifying Callback 0x{:x}", (std::uintptr_t)&cb);
             cb();
         }
@@ -1,8 +1,13 @@
 #pragma once
 
-#include <mutex>
-#include <queue>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <thread>
 
+#include "game/log/Log.h"
+#include "game/state/MpscQueue.h"
+#include "game/timing/TickScheduler.h"
 #include "spdlog/spdlog.h"
 
 namespace game::state {
@@ -22,26 +27,116 @@ namespace game::state {
         }
     }
 
+    /** @brief Number of Event values */
+    constexpr size_t EVENT_COUNT = static_cast<size_t>(Event::PLUGIN_3) + 1;
+
+    /** @brief Set of Events, usable at compile time to declare which Events a handler is interested in. */
+    class EventSet {
+       public:
+        constexpr EventSet() = default;
+        constexpr EventSet(std::initializer_list<Event> events) {
+            for (auto event : events) _bits |= _bit(event);
+        }
+
+        [[nodiscard]] constexpr bool contains(Event event) const { return _bits & _bit(event); }
+        [[nodiscard]] constexpr bool empty() const { return _bits == 0; }
+        constexpr EventSet operator|(EventSet other) const { return EventSet(_bits | other._bits); }
+
+       private:
+        constexpr explicit EventSet(uint32_t bits) : _bits(bits) {}
+        static constexpr uint32_t _bit(Event event) { return uint32_t(1) << static_cast<uint32_t>(event); }
+
+        uint32_t _bits = 0;
+    };
+
+    /** @brief An Event, along with the time it was pushed by the plugin callback. */
+    struct TimedEvent {
+        Event event;
+        timing::Clock::time_point timestamp;
+    };
+
+    /**
+     * @brief Delivers the Events pushed by the plugins to a Dispatcher, from a dedicated notifier thread.
+     *
+     * push() never blocks: the Event is written into a lock-free ring and the notifier is woken up through an atomic
+     * wait, so plugin callback threads never contend with the notifier. If the ring is full, the Event is dropped.
+     *
+     * Every Event is stamped on push(), and the timestamp travels with it up to the handlers, so that the latency
+     * between a key press and its effect on screen can be measured.
+     *
+     * @tparam Dispatcher Callable with signature void(TimedEvent), usually an EventRouter, called directly without
+     * any type erasure.
+     */
+    template <class Dispatcher>
     class EventQueue {
        public:
-        using Callback = std::function<void(Event)>;
+        /** @brief Number of Events that can be pending at once */
+        static constexpr size_t CAPACITY = 1024;
 
-        EventQueue();
+        explicit EventQueue(Dispatcher dispatcher);
         ~EventQueue();
 
+        /** @brief Stamp the Event with the current time, and push it. */
         void push(Event event);
-        void subscribe(Callback&& cb);
+        void push(TimedEvent event);
 
        private:
-        void _notify(Event event);
         void _await_events();
 
        private:
+        Dispatcher _dispatch;
         std::atomic<bool> _exit{false};
-        std::mutex _mtx;
-        std::condition_variable _cv;
-        std::vector<Callback> _subs;
-        std::vector<Event> _queue;
+        /** @brief Bumped on every push(), the notifier sleeps on it */
+        std::atomic<uint32_t> _epoch{0};
+        std::atomic<size_t> _dropped{0};
+        MpscQueue<TimedEvent, CAPACITY> _queue;
         std::jthread _worker;  // must be the last
     };
+
+    template <class Dispatcher>
+    EventQueue<Dispatcher>::EventQueue(Dispatcher dispatcher)
+        : _dispatch(std::move(dispatcher)), _worker(&EventQueue::_await_events, this) {
+        SPDLOG_INFO("EventQueue starting...");
+    }
+
+    template <class Dispatcher>
+    EventQueue<Dispatcher>::~EventQueue() {
+        _exit = true;
+        _epoch.fetch_add(1, std::memory_order_release);
+        _epoch.notify_one();
+    }
+
+    template <class Dispatcher>
+    void EventQueue<Dispatcher>::push(Event event) {
+        push({.event = event, .timestamp = timing::Clock::now()});
+    }
+
+    template <class Dispatcher>
+    void EventQueue<Dispatcher>::push(TimedEvent event) {
+        if (!_queue.push(event)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _epoch.fetch_add(1, std::memory_order_release);
+        _epoch.notify_one();
+    }
+
+    template <class Dispatcher>
+    void EventQueue<Dispatcher>::_await_events() {
+        SPDLOG_INFO("EventQueue [notifier] starting...");
+
+        while (!_exit) {
+            auto epoch = _epoch.load(std::memory_order_acquire);
+            if (auto dropped = _dropped.exchange(0, std::memory_order_relaxed); dropped) {
+                SPDLOG_WARN("EventQueue full, {} events dropped!", dropped);
+            }
+            if (auto event = _queue.pop(); event) {
+                NIBBLER_PROBE(log::Probe::EVENT, static_cast<uint64_t>(event->event));
+                _dispatch(*event);
+                continue;
+            }
+            _epoch.wait(epoch, std::memory_order_acquire);
+        }
+        SPDLOG_INFO("EventQueue [notifier] exiting...");
+    }
 }  // namespace game::state
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "game/state/Event.h"
+
+namespace game::state {
+    /**
+     * @brief Routes each Event only to the handlers interested in it, with a table built at compile time.
+     *
+     * Each handler declares the Events it wants through a static constexpr EventSet EVENTS member, and receives them
+     * through a void handle_event(TimedEvent) method. For every Event, the router knows at compile time which handlers
+     * want it, and calls them directly, in the order they were given. Events nobody wants cost a single table lookup.
+     *
+     * auto router = EventRouter<PluginSwitcher, Context>(switcher, context);
+     * router({.event = Event::UP, .timestamp = now});  // only reaches context
+     *
+     * @tparam Handlers The handler types.
+     */
+    template <class... Handlers>
+    class EventRouter {
+        static_assert(sizeof...(Handlers) <= 32, "EventRouter supports up to 32 handlers");
+
+       public:
+        explicit EventRouter(Handlers &...handlers) : _handlers(handlers...) {}
+
+        void operator()(TimedEvent event) const {
+            _route(event, TABLE[static_cast<size_t>(event.event)], std::index_sequence_for<Handlers...>{});
+        }
+
+       private:
+        /** @brief For each Event, the bitmask of the handlers interested in it */
+        static constexpr std::array<uint32_t, EVENT_COUNT> TABLE = [] {
+            std::array<uint32_t, EVENT_COUNT> table{};
+            constexpr EventSet sets[] = {Handlers::EVENTS...};
+            for (size_t e = 0; e < EVENT_COUNT; ++e)
+                for (size_t h = 0; h < sizeof...(Handlers); ++h)
+                    if (sets[h].contains(static_cast<Event>(e))) table[e] |= uint32_t(1) << h;
+            return table;
+        }();
+
+        template <size_t... I>
+        void _route(TimedEvent event, uint32_t mask, std::index_sequence<I...>) const {
+            ((mask & (uint32_t(1) << I) ? std::get<I>(_handlers).handle_event(event) : void()), ...);
+        }
+
+       private:
+        std::tuple<Handlers &...> _handlers;
+    };
+}  // namespace game::state
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+
+namespace game::state {
+    /**
+     * @brief Bounded lock-free multi-producer/single-consumer queue.
+     *
+     * Each slot carries a sequence number telling whether it is free for the producer of a given position, or filled
+     * for the consumer of that position. Producers only contend on a compare-and-swap of the tail, and never wait for
+     * the consumer: when the queue is full, push() fails immediately.
+     *
+     * @tparam T Trivially copyable element type.
+     * @tparam N Capacity, must be a power of two.
+     */
+    template <class T, size_t N>
+    class MpscQueue {
+        static_assert(std::has_single_bit(N), "N must be a power of two");
+
+        struct Slot {
+            std::atomic<size_t> seq;
+            T value;
+        };
+
+       public:
+        MpscQueue() {
+            for (size_t i = 0; i < N; ++i) _slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Enqueue a value, safe to call from any number of threads.
+         * @returns false if the queue is full, in which case the value is dropped.
+         */
+        bool push(T value) {
+            size_t pos = _tail.load(std::memory_order_relaxed);
+            while (true) {
+                auto &slot = _slots[pos & (N - 1)];
+                auto diff = static_cast<std::ptrdiff_t>(slot.seq.load(std::memory_order_acquire) - pos);
+                if (diff == 0) {
+                    if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = _tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Dequeue a value, must only be called by the single consumer thread.
+         * @returns The oldest value, or std::nullopt if the queue is empty.
+         */
+        std::optional<T> pop() {
+            auto &slot = _slots[_head & (N - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != _head + 1) return std::nullopt;
+            T value = slot.value;
+            slot.seq.store(_head + N, std::memory_order_release);
+            ++_head;
+            return value;
+        }
+
+       private:
+        std::array<Slot, N> _slots;
+        /** @brief Next position to be written, shared by the producers */
+        alignas(64) std::atomic<size_t> _tail{0};
+        /** @brief Next position to be read, owned by the consumer */
+        alignas(64) size_t _head = 0;
+    };
+}  // namespace game::state
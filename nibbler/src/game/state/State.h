@@ -0,0 +1,38 @@
+#pragma once
+
+#include "game/Config.h"
+#include "game/plugin/Plugin.h"
+#include "game/state/Event.h"
+
+namespace game::state {
+    class Context;
+
+    /**
+     * @brief Base of every concrete State held by the Context.
+     *
+     * A concrete State must be constructible from a Context reference, must declare the Events it wants through a
+     * static constexpr EventSet EVENTS member and, unless EVENTS is empty, must provide a void handle_event(TimedEvent)
+     * method. The Context knows every concrete State at compile time, so there is no virtual dispatch involved.
+     */
+    class State {
+       public:
+        explicit State(Context& context);
+
+       protected:
+        /**
+         * @brief Friendship is not transitive (a friend of your friend is not your friend).
+         *
+         * The transition is deferred: it happens once the current call into the State returns, so that a State is
+         * never destroyed while one of its methods is running.
+         *
+         * @tparam T State to be changed to.
+         */
+        template <class T>
+        void context_change_state();
+
+        config::Config const& config() const;
+        plugin::PluginSwitcher& plugins();
+
+        Context& _context;
+    };
+}  // namespace game::state
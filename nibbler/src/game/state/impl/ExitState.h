@@ -1,13 +1,13 @@
 #pragma once
 
-#include "game/state/Context.h"
+#include "game/state/State.h"
 
 namespace game::state::impl {
     class ExitState : public State {
        public:
-        explicit ExitState(Context& context);
-        ~ExitState() override = default;
+        /** @brief The final State, it does not handle any Event */
+        static constexpr EventSet EVENTS{};
 
-        void handle_event(Event event) override;
+        explicit ExitState(Context& context);
     };
 }  // namespace game::state::impl
@@ -1,18 +1,23 @@
 #include "MainMenuState.h"
 
+#include "game/state/Context.h"
 #include "game/state/impl/PlayingState.h"
 
 namespace game::state::impl {
     MainMenuState::MainMenuState(Context& context)
-        : State(context), _menu({.name = "Main Menu", .hover_pos = 0, .options = {PLAY, EXIT}}) {}
+        : State(context), _menu({.name = "Main Menu", .hover_pos = 0, .options = {PLAY, EXIT}}) {
+        plugins().display_menu(_menu);
+        // Nobody is there to press Enter
+        if (config().autopilot) context_change_state<impl::PlayingState>();
+    }
 
-    void MainMenuState::handle_event(Event event) {
-        switch (event) {
+    void MainMenuState::handle_event(TimedEvent event) {
+        switch (event.event) {
             case Event::EXIT: _exit(); break;
             case Event::UP: _change_hover_position(true); break;
             case Event::DOWN: _change_hover_position(false); break;
             case Event::ENTER: _enter(); break;
-            default: SPDLOG_DEBUG("Ignoring event {}", toString(event));
+            default: SPDLOG_DEBUG("Ignoring event {}", toString(event.event));
         }
     }
     void MainMenuState::_change_hover_position(bool up) {
@@ -24,6 +29,7 @@ namespace game::state::impl {
             _menu.hover_pos = (_menu.hover_pos + 1) % _menu.options.size();
         }
         SPDLOG_DEBUG("Option({}) selected", _menu.options.at(_menu.hover_pos));
+        plugins().display_menu(_menu);
     }
     void MainMenuState::_exit() { context_change_state<ExitState>(); }
     void MainMenuState::_enter() {
@@ -2,7 +2,7 @@
 
 #include "game/Menu.h"
 #include "game/plugin/Plugin.h"
-#include "game/state/Context.h"
+#include "game/state/State.h"
 #include "game/state/impl/ExitState.h"
 
 namespace game::state::impl {
@@ -10,11 +10,11 @@ namespace game::state::impl {
        public:
         static constexpr std::string_view PLAY = "Play";
         static constexpr std::string_view EXIT = "Exit";
+        static constexpr EventSet EVENTS{Event::EXIT, Event::UP, Event::DOWN, Event::ENTER};
 
         explicit MainMenuState(Context& context);
-        ~MainMenuState() override = default;
 
-        void handle_event(Event event) override;
+        void handle_event(TimedEvent event);
 
        private:
         void _change_hover_position(bool up);
@@ -1,29 +1,67 @@
 #include "PlayingState.h"
 
+#include "game/engine/exception.h"
+#include "game/log/Log.h"
+#include "game/state/Context.h"
 #include "game/state/impl/ExitState.h"
 
 namespace game::state::impl {
 
-    PlayingState::PlayingState(Context& context) : State(context), _worker(&PlayingState::_loop, this) {
+    PlayingState::PlayingState(Context& context)
+        : State(context),
+          _ticker(config().game_tick, config().tick_policy, config().tick_spin) {
         try {
-            _snake = std::make_unique<snake::Snake>(config().game_width, config().game_height);
+            _engine = std::make_unique<engine::Engine>(config().game_width, config().game_height, snake::random_seed());
+            auto const& conf = config();
+            auto window = [](size_t board, uint32_t view, uint32_t display) {
+                return static_cast<uint32_t>(std::min<size_t>({board, view ? view : board, display}));
+            };
+            auto view = render::Extent{.width = window(conf.game_width, conf.view_width, conf.display_width),
+                                       .height = window(conf.game_height, conf.view_height, conf.display_height)};
+            auto scale = render::Extent{.width = std::max(1u, config().display_width / view.width),
+                                        .height = std::max(1u, config().display_height / view.height)};
+            _frame = std::make_unique<render::Frame>(view, scale);
+            _follow();
+            if (config().autopilot) {
+                try {
+                    _autopilot = std::make_unique<engine::Autopilot>(config().game_width, config().game_height,
+                                                                     config().autopilot_budget);
+                    _change_opt(Options::RUNNING);
+                } catch (engine::exception::AutopilotBoardSizeException& e) {
+                    SPDLOG_ERROR("{} Playing by hand.", e.what());
+                }
+            }
+            if (!config().replay_path.empty()) {
+                _replay = std::make_unique<engine::ReplayWriter>(config().replay_path, *_engine);
+                _replay->turn(0, _orientation, 0);
+                SPDLOG_INFO("Recording to {}, seed {}", config().replay_path, _engine->seed());
+            }
         } catch (snake::exception::SnakeSmallMatrixException& e) {
             SPDLOG_CRITICAL("{}", e.what());
             context_change_state<ExitState>();
+        } catch (snake::exception::SnakeLargeMatrixException& e) {
+            SPDLOG_CRITICAL("{}", e.what());
+            context_change_state<ExitState>();
+        } catch (engine::exception::ReplayIOException& e) {
+            SPDLOG_ERROR("{} Not recording.", e.what());
         }
+        // Last, so that nothing can throw once the loop runs: it would never be told to exit
+        _worker = std::jthread(&PlayingState::_loop, this);
     }
 
-    void PlayingState::handle_event(Event event) {
+    PlayingState::~PlayingState() { _change_opt(Options::EXIT); }
+
+    void PlayingState::handle_event(TimedEvent event) {
         // TODO: can do better...
-        switch (event) {
+        switch (event.event) {
             case Event::EXIT:
                 _change_opt(Options::EXIT);
                 context_change_state<ExitState>();
                 break;
-            case Event::UP: _orientation = snake::Orientation::NORTH; break;
-            case Event::DOWN: _orientation = snake::Orientation::SOUTH; break;
-            case Event::LEFT: _orientation = snake::Orientation::WEST; break;
-            case Event::RIGHT: _orientation = snake::Orientation::EAST; break;
+            case Event::UP: _turn(snake::Orientation::NORTH, event.timestamp); break;
+            case Event::DOWN: _turn(snake::Orientation::SOUTH, event.timestamp); break;
+            case Event::LEFT: _turn(snake::Orientation::WEST, event.timestamp); break;
+            case Event::RIGHT: _turn(snake::Orientation::EAST, event.timestamp); break;
             case Event::ENTER:
                 switch (_opt) {
                     case Options::PAUSED: _change_opt(Options::RUNNING); break;
@@ -31,35 +69,99 @@ namespace game::state::impl {
                     default:;
                 }
                 break;
-            default: SPDLOG_DEBUG("Ignoring event {}", toString(event));
+            default: SPDLOG_DEBUG("Ignoring event {}", toString(event.event));
         }
     }
 
     void PlayingState::_change_opt(PlayingState::Options opt) {
-        _opt = opt;
+        {
+            std::lock_guard lk(_mtx_opt);
+            _opt = opt;
+        }
         _cv.notify_one();
     }
 
+    void PlayingState::_turn(snake::Orientation orientation, timing::Clock::time_point timestamp) {
+        if (!_turns.push({.orientation = orientation, .timestamp = timestamp})) {
+            NIBBLER_PROBE(log::Probe::TURN_DROPPED, static_cast<uint64_t>(orientation));
+        }
+    }
+
+    void PlayingState::_record_turn(snake::Orientation orientation, timing::Clock::time_point timestamp) {
+        _orientation = orientation;
+        if (_replay) {
+            auto since = std::chrono::nanoseconds(timestamp - _started);
+            _replay->turn(_engine->ticks(), _orientation, static_cast<uint64_t>(since.count()));
+        }
+    }
+
+    void PlayingState::_follow() {
+        auto [x, y] = _engine->snake()._player.head();
+        _frame->follow({.x = static_cast<uint32_t>(x), .y = static_cast<uint32_t>(y)},
+                       {.width = static_cast<uint32_t>(config().game_width),
+                        .height = static_cast<uint32_t>(config().game_height)});
+    }
+
+    void PlayingState::_present() {
+        _follow();
+        auto& board = _engine->snake()._board;
+        plugins().display_game(*_frame, board.matrix(), board.damage());
+        board.damage().clear();
+    }
+
     void PlayingState::_loop() {
         SPDLOG_DEBUG("PLayingState loop start");
         while (_opt != Options::EXIT) {
-            std::unique_lock lk(_mtx_opt);
-
-            _cv.wait(lk, [this] { return _opt != Options::PAUSED; });
-            if (_opt == Options::EXIT) return;
+            if (_opt == Options::PAUSED) {
+                std::unique_lock lk(_mtx_opt);
+                _cv.wait(lk, [this] { return _opt != Options::PAUSED; });
+                _ticker.start();
+            }
+            if (_opt == Options::EXIT) break;
 
-            try {
-                _snake->_player.move(_orientation);
-                _snake->_debug();  // TODO IMPROVE
+            std::optional<timing::Clock::time_point> pressed;
+            if (auto turn = _turns.pop(); turn && !_autopilot) {
+                pressed = turn->timestamp;
+                _record_turn(turn->orientation, turn->timestamp);
+            } else if (_autopilot) {
+                if (auto orientation = (*_autopilot)(*_engine); orientation != _orientation) {
+                    _record_turn(orientation, timing::Clock::now());
+                }
+            }
 
-            } catch (snake::exception::PlayerHitException& e) {
-                SPDLOG_CRITICAL("{}", e.what());
-                _snake->_debug();  // TODO IMPROVE
-                return;
+            auto outcome = _engine->step(_orientation);
+            _present();
+            NIBBLER_PROBE(log::Probe::TICK, _engine->ticks(), static_cast<uint64_t>(outcome));
+            if (pressed) {
+                auto latency = static_cast<uint64_t>(std::chrono::nanoseconds(timing::Clock::now() - *pressed).count());
+                _input_latency.record(latency);
+                NIBBLER_PROBE(log::Probe::INPUT_LATENCY, _engine->ticks(), latency);
+            }
+            if (_engine->over()) {
+                SPDLOG_CRITICAL("Game over, {}",
+                                outcome == engine::Outcome::WON ? "board is full!" : "player hit something!");
+                break;
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(config().game_speed_ms));
+            _ticker.wait();
+        }
+        if (_replay) _replay->end(*_engine);
+        _log_stats();
+    }
+
+    void PlayingState::_log_stats() const {
+        if (_autopilot) {
+            auto const& moves = _autopilot->stats();
+            SPDLOG_INFO("Autopilot moves: {}, to the food: {}, detours: {}, over budget: {}, length: {}", moves.moves,
+                        moves.paths, moves.detours, moves.overruns, _engine->snake()._player.body().size() + 1);
         }
+        auto const& stats = _ticker.stats();
+        SPDLOG_INFO("Ticks: {}, missed: {}, skipped: {}, lateness (us) p50: {}, p99: {}, max: {}",
+                    stats.lateness.count(), stats.missed, stats.skipped, stats.lateness.percentile(50) / 1000,
+                    stats.lateness.percentile(99) / 1000, stats.lateness.max() / 1000);
+        SPDLOG_INFO("Turns: {}, input to display latency (us) p50: {}, p90: {}, p99: {}, max: {}",
+                    _input_latency.count(), _input_latency.percentile(50) / 1000, _input_latency.percentile(90) / 1000,
+                    _input_latency.percentile(99) / 1000, _input_latency.max() / 1000);
     }
 
 }  // namespace game::state::impl
@@ -1,27 +1,62 @@
 #pragma once
 
-#include "game/snake/Snake.h"
-#include "game/state/Context.h"
+#include "game/engine/Autopilot.h"
+#include "game/engine/Engine.h"
+#include "game/engine/Replay.h"
+#include "game/render/Frame.h"
+#include "game/state/State.h"
+#include "game/state/MpscQueue.h"
+#include "game/timing/Histogram.h"
+#include "game/timing/TickScheduler.h"
 
 namespace game::state::impl {
     class PlayingState : public State {
         enum class Options { PAUSED, RUNNING, EXIT };
 
+        /** @brief A direction change requested by the player, and when the key was pressed */
+        struct Turn {
+            snake::Orientation orientation;
+            timing::Clock::time_point timestamp;
+        };
+        /** @brief Number of turns that can be buffered ahead of the game loop */
+        static constexpr size_t TURN_BUFFER = 4;
+
        public:
+        static constexpr EventSet EVENTS{Event::EXIT, Event::UP, Event::DOWN, Event::LEFT, Event::RIGHT, Event::ENTER};
+
         explicit PlayingState(Context& context);
-        ~PlayingState() override = default;
-        void handle_event(Event event) override;
+        ~PlayingState();
+        void handle_event(TimedEvent event);
 
        private:
         void _change_opt(Options opt);
+        void _turn(snake::Orientation orientation, timing::Clock::time_point timestamp);
+        /** @brief Change direction, and record it in the replay */
+        void _record_turn(snake::Orientation orientation, timing::Clock::time_point timestamp);
         void _loop();
+        /** @brief Keep the head of the Player inside the Frame */
+        void _follow();
+        void _present();
+        void _log_stats() const;
 
        private:
-        std::unique_ptr<snake::Snake> _snake;
-        std::atomic<snake::Orientation> _orientation{snake::Orientation::SOUTH};
+        std::unique_ptr<engine::Engine> _engine;
+        std::unique_ptr<render::Frame> _frame;
+        /** @brief Only when Config::replay_path is set */
+        std::unique_ptr<engine::ReplayWriter> _replay;
+        timing::Clock::time_point _started{timing::Clock::now()};
+        /** @brief Only when Config::autopilot is set, replaces the player */
+        std::unique_ptr<engine::Autopilot> _autopilot;
+        /** @brief Turns not applied yet, the game loop consumes one per tick, in order */
+        MpscQueue<Turn, TURN_BUFFER> _turns;
+        /** @brief Current direction, only touched by the game loop */
+        snake::Orientation _orientation{snake::Orientation::SOUTH};
+        /** @brief Time between a key press and the display of the tick it was applied to */
+        timing::Histogram _input_latency;
         std::atomic<Options> _opt{Options::PAUSED};
         std::mutex _mtx_opt;
         std::condition_variable _cv;
+        timing::TickScheduler _ticker;
         std::jthread _worker;
     };
 }  // namespace game::state::impl
@@ -0,0 +1,43 @@
+#include "Histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace game::timing {
+    size_t Histogram::_bucket(uint64_t ns) {
+        if (ns < SUB_BUCKETS) return ns;
+        const unsigned msb = 63 - std::countl_zero(ns);
+        const auto sub = static_cast<size_t>((ns >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+        return (msb - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    uint64_t Histogram::_upper_bound(size_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        const unsigned msb = bucket / SUB_BUCKETS + SUB_BITS - 1;
+        const uint64_t sub = bucket % SUB_BUCKETS;
+        const uint64_t low = (uint64_t(1) << msb) | (sub << (msb - SUB_BITS));
+        return low + (uint64_t(1) << (msb - SUB_BITS)) - 1;
+    }
+
+    void Histogram::record(uint64_t ns) {
+        ++_buckets[_bucket(ns)];
+        ++_count;
+        _sum += ns;
+        _max = std::max(_max, ns);
+    }
+
+    void Histogram::clear() { *this = Histogram(); }
+
+    uint64_t Histogram::percentile(double p) const {
+        if (_count == 0) return 0;
+        auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * double(_count)));
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < _buckets.size(); ++i) {
+            seen += _buckets[i];
+            if (seen >= rank) return std::min(_upper_bound(i), _max);
+        }
+        return _max;
+    }
+}  // namespace game::timing
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace game::timing {
+    /**
+     * @brief Fixed-size log-linear histogram of durations, in nanoseconds.
+     *
+     * Values are bucketed by power of two, each power being split in SUB_BUCKETS linear buckets, so the relative error
+     * of any reported percentile is below 1 / SUB_BUCKETS. record() is a handful of integer instructions and never
+     * allocates, so it can be called on hot paths. Not thread safe.
+     */
+    class Histogram {
+       public:
+        static constexpr unsigned SUB_BITS = 3;
+        static constexpr unsigned SUB_BUCKETS = 1u << SUB_BITS;
+
+        void record(uint64_t ns);
+        void clear();
+
+        /**
+         * @param p Percentile, in [0, 100].
+         * @returns An upper bound of the p-th percentile, 0 if empty.
+         */
+        [[nodiscard]] uint64_t percentile(double p) const;
+        [[nodiscard]] uint64_t count() const { return _count; }
+        [[nodiscard]] uint64_t max() const { return _max; }
+        [[nodiscard]] uint64_t mean() const { return _count ? _sum / _count : 0; }
+
+       private:
+        static size_t _bucket(uint64_t ns);
+        static uint64_t _upper_bound(size_t bucket);
+
+       private:
+        std::array<uint64_t, 64 * SUB_BUCKETS> _buckets{};
+        uint64_t _count = 0;
+        uint64_t _sum = 0;
+        uint64_t _max = 0;
+    };
+}  // namespace game::timing
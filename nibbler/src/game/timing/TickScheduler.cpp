@@ -0,0 +1,46 @@
+#include "TickScheduler.h"
+
+#include <thread>
+
+#include "game/log/Log.h"
+
+namespace game::timing {
+    TickScheduler::TickScheduler(Clock::duration period, TickPolicy policy, Clock::duration spin)
+        : _period(period), _policy(policy), _spin(spin), _deadline(Clock::now() + period) {}
+
+    void TickScheduler::start() { _deadline = Clock::now() + _period; }
+
+    void TickScheduler::wait() {
+        if (_period == Clock::duration::zero()) return;
+
+        if (Clock::now() < _deadline - _spin) {
+            std::this_thread::sleep_until(_deadline - _spin);
+        }
+        auto now = Clock::now();
+        while (now < _deadline) now = Clock::now();
+
+        auto late = now - _deadline;
+        auto late_ns = static_cast<uint64_t>(std::chrono::nanoseconds(late).count());
+        _stats.lateness.record(late_ns);
+        NIBBLER_PROBE(log::Probe::LATENESS, late_ns);
+        if (late <= _period) {
+            _deadline += _period;
+            return;
+        }
+
+        ++_stats.missed;
+        switch (_policy) {
+            case TickPolicy::CATCH_UP: _deadline += _period; break;
+            case TickPolicy::SKIP: {
+                auto behind = late / _period;
+                _stats.skipped += static_cast<uint64_t>(behind);
+                _deadline += (behind + 1) * _period;
+                break;
+            }
+        }
+    }
+
+    TickStats const &TickScheduler::stats() const { return _stats; }
+
+    Clock::duration TickScheduler::period() const { return _period; }
+}  // namespace game::timing
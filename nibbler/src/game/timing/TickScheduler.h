@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "game/timing/Histogram.h"
+
+namespace game::timing {
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief What the TickScheduler does when it falls behind by more than one period. */
+    enum class TickPolicy {
+        CATCH_UP,  ///< Run the missed ticks back to back, until the schedule is met again
+        SKIP       ///< Drop the missed ticks, and resume on the next deadline still in the future
+    };
+
+    /** @brief Telemetry of a TickScheduler, all durations in nanoseconds. */
+    struct TickStats {
+        /** @brief How late each tick started, relative to its deadline */
+        Histogram lateness;
+        /** @brief Ticks that started more than one period after their deadline */
+        uint64_t missed = 0;
+        /** @brief Ticks dropped by TickPolicy::SKIP */
+        uint64_t skipped = 0;
+    };
+
+    /**
+     * @brief Fixed-timestep scheduler based on absolute deadlines.
+     *
+     * Each tick has a deadline on the steady clock, computed from the previous deadline and not from the time the
+     * previous tick ended, so the work done during a tick never makes the tick rate drift. To reach sub-millisecond
+     * periods despite the coarseness of sleep_until(), the last part of each wait can be spent spinning.
+     */
+    class TickScheduler {
+       public:
+        /**
+         * @brief TickScheduler constructor.
+         * @param period Time between two deadlines, 0 never waits.
+         * @param policy What to do when falling behind.
+         * @param spin How long before each deadline the scheduler stops sleeping and starts spinning.
+         */
+        explicit TickScheduler(Clock::duration period, TickPolicy policy = TickPolicy::SKIP,
+                               Clock::duration spin = Clock::duration::zero());
+
+        /** @brief Schedule the first deadline one period from now, e.g. when starting or resuming the game. */
+        void start();
+
+        /** @brief Block until the next deadline, then record how late it was woken up and schedule the next one. */
+        void wait();
+
+        [[nodiscard]] TickStats const &stats() const;
+        [[nodiscard]] Clock::duration period() const;
+
+       private:
+        Clock::duration _period;
+        TickPolicy _policy;
+        Clock::duration _spin;
+        Clock::time_point _deadline;
+        TickStats _stats;
+    };
+}  // namespace game::timing
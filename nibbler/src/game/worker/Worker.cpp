@@ -5,7 +5,18 @@
 #include "Worker.h"
 
 namespace game::worker {
+    namespace {
+        /** @brief The pool owning the current thread, if any, and the index of its deque */
+        thread_local Worker const* t_owner = nullptr;
+        thread_local size_t t_id = 0;
+    }  // namespace
+
     Worker::Worker(size_t n) {
+        if (n == 0) n = std::max(1u, std::thread::hardware_concurrency());
+        _queues.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            _queues.push_back(std::make_unique<Queue>());
+        }
         _pool.reserve(n);
         for (size_t i = 0; i < n; i++) {
             _pool.emplace_back(&Worker::_wait_task, this, i);
@@ -14,31 +25,61 @@ namespace game::worker {
 
     Worker::~Worker() {
         _exit = true;
-        _cv_wait.notify_all();
+        _pending.fetch_add(1);
+        _pending.notify_all();
     }
 
-    void Worker::push_task(Worker::Task&& task) {
-        _mtx_task.lock();
-        _task = task;
-        _cv_wait.notify_one();
+    size_t Worker::size() const { return _queues.size(); }
+
+    void Worker::_push(Worker::Task&& task) {
+        auto id = t_owner == this ? t_id : _next.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+        _pending.fetch_add(1);
+        {
+            std::lock_guard lk(_queues[id]->mtx);
+            _queues[id]->tasks.push_back(std::move(task));
+        }
+        _pending.notify_one();
     }
 
-    void Worker::_wait_task([[maybe_unused]] int id) {
-        SPDLOG_DEBUG("Hello from worker thread [{}]", id);
+    bool Worker::_try_pop(Worker::Task& task) {
+        const size_t n = _queues.size();
+        const size_t self = t_owner == this ? t_id : 0;
+        if (t_owner == this) {
+            std::lock_guard lk(_queues[self]->mtx);
+            if (auto& tasks = _queues[self]->tasks; !tasks.empty()) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            auto& victim = *_queues[(self + i + 1) % n];
+            std::lock_guard lk(victim.mtx);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
 
-        while (true) {
-            std::unique_lock lk_wait(_mtx_wait);
-            _cv_wait.wait(lk_wait, [this] { return _exit || _task; });
-            if (_exit) return;
+    bool Worker::_run_one() {
+        Task task;
+        if (!_try_pop(task)) return false;
+        _pending.fetch_sub(1);
+        task();
+        return true;
+    }
 
-            auto task = Task();
-            {
-                std::unique_lock lk_task(_mtx_task, std::adopt_lock);
-                task = std::move(_task);
-                _task = nullptr;
-            }
-            lk_wait.unlock();
-            task();
+    void Worker::_wait_task(size_t id) {
+        SPDLOG_DEBUG("Hello from worker thread [{}]", id);
+        t_owner = this;
+        t_id = id;
+
+        while (!_exit) {
+            if (_run_one()) continue;
+            _pending.wait(0);
         }
 
         SPDLOG_DEBUG("Goodbye from worker thread [{}]", id);
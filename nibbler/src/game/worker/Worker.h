@@ -2,30 +2,131 @@
 
 #include <spdlog/spdlog.h>
 
-#include <condition_variable>
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace game::worker {
+    /**
+     * @brief Work-stealing thread pool.
+     *
+     * Each thread owns a deque of tasks: it pops its own tasks from the back (most recent first, while still hot in
+     * cache) and, when it runs dry, steals the oldest tasks from the front of the other deques. Tasks submitted from
+     * outside the pool are spread round-robin across the deques, so producers never serialize behind a single slot.
+     * Idle threads sleep on an atomic counter of pending tasks.
+     *
+     * The expected usage is:
+     *
+     * auto pool = Worker(4);
+     * auto future = pool.submit([] { return 42; });
+     * pool.parallel_for(0, n, [&](size_t begin, size_t end) { ... });
+     */
     class Worker {
        public:
         using Task = std::function<void()>;
 
-        explicit Worker(size_t n);
+        /**
+         * @brief Worker constructor.
+         * @param n Number of threads, 0 for one per hardware thread.
+         */
+        explicit Worker(size_t n = 0);
         ~Worker();
 
-        void push_task(Task&& task);
+        Worker(Worker const &) = delete;
+        Worker(Worker &&) = delete;
+
+        /**
+         * @brief Schedule a callable to run on the pool.
+         * @param f The callable, taking no argument.
+         * @returns A future holding the result of f, or the exception it threw.
+         */
+        template <class F>
+        [[nodiscard]] std::future<std::invoke_result_t<F>> submit(F &&f);
+
+        /**
+         * @brief Run f over [begin, end) split in chunks across the pool, and wait for all of them.
+         *
+         * The calling thread runs pending tasks while it waits, so parallel_for() can safely be called from inside a
+         * task. The first exception thrown by f, if any, is rethrown once every chunk is done.
+         *
+         * @param begin First index.
+         * @param end One past the last index.
+         * @param f Callable with signature void(size_t chunk_begin, size_t chunk_end).
+         * @param grain Minimum number of indices per chunk.
+         */
+        template <class F>
+        void parallel_for(size_t begin, size_t end, F &&f, size_t grain = 1);
+
+        /** @return The number of threads of the pool. */
+        [[nodiscard]] size_t size() const;
 
        private:
-        void _wait_task([[maybe_unused]] int id);
+        struct Queue {
+            std::mutex mtx;
+            std::deque<Task> tasks;
+        };
+
+        void _push(Task &&task);
+        /** @brief Pop a task from the calling thread's own deque, or steal one, returns false if none was found. */
+        bool _try_pop(Task &task);
+        /** @brief Run a single pending task, if any, returns false if there was none. */
+        bool _run_one();
+        void _wait_task(size_t id);
 
        private:
-        Task _task;
-        std::mutex _mtx_wait;
-        std::mutex _mtx_task;
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::atomic<size_t> _next{0};
+        std::atomic<size_t> _pending{0};
         std::atomic<bool> _exit{false};
-        std::condition_variable _cv_wait;
-        std::vector<std::jthread> _pool;
+        std::vector<std::jthread> _pool;  // must be the last
     };
-}  // namespace game::worker
\ No newline at end of file
+
+    template <class F>
+    std::future<std::invoke_result_t<F>> Worker::submit(F &&f) {
+        using R = std::invoke_result_t<F>;
+        // std::function must be copyable, std::packaged_task is not.
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        auto future = task->get_future();
+        _push([task] { (*task)(); });
+        return future;
+    }
+
+    template <class F>
+    void Worker::parallel_for(size_t begin, size_t end, F &&f, size_t grain) {
+        if (begin >= end) return;
+        const size_t count = end - begin;
+        const size_t chunks = std::max<size_t>(1, std::min(count / std::max<size_t>(grain, 1), size() * 4));
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(chunks - 1);
+        for (size_t i = 1; i < chunks; ++i) {
+            futures.push_back(submit([&f, b = begin + i * count / chunks, e = begin + (i + 1) * count / chunks] {
+                f(b, e);
+            }));
+        }
+
+        std::exception_ptr error;
+        try {
+            f(begin, begin + count / chunks);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (auto &future : futures) {
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (!_run_one()) std::this_thread::yield();
+            }
+            try {
+                future.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+}  // namespace game::worker
@@ -1,9 +1,49 @@
+#include <chrono>
+#include <string_view>
+
 #include "game/App.h"
+#include "game/engine/Replay.h"
+#include "game/log/Log.h"
+
+namespace {
+    /** @brief nibbler --replay <file>: plays a recorded game headless, and checks it ends the same way */
+    int replay(char const *path) {
+        using namespace game::engine;
+        try {
+            auto const replay = Replay::load(path);
+            auto const start = std::chrono::steady_clock::now();
+            auto const result = play(replay);
+            auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+            SPDLOG_INFO("Replayed {}: seed {}, {}x{}, {} inputs, {} ticks in {:.3f}ms ({:.0f} ticks/s)", path,
+                        replay.header.seed, replay.header.width, replay.header.height, replay.records.size(),
+                        result.ticks, elapsed.count() * 1e3, static_cast<double>(result.ticks) / elapsed.count());
+            if (!result.matches) {
+                SPDLOG_ERROR("Replay diverged: ended at tick {} with outcome {}, hash {:#x}", result.ticks,
+                             static_cast<int>(result.outcome), result.hash);
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        } catch (std::exception const &e) {
+            SPDLOG_CRITICAL("{}", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+}  // namespace
 
 int main(int ac, char const *av[]) {
-    auto app = game::App(ac, av);
+    if (ac == 3 && std::string_view(av[1]) == "--replay") {
+        game::log::init();
+        auto status = replay(av[2]);
+        game::log::shutdown();
+        return status;
+    }
+    {
+        auto app = game::App(ac, av);
 
-    app.init();
-    app.run();
+        app.init();
+        app.run();
+    }
+    game::log::shutdown();
     return EXIT_SUCCESS;
 }
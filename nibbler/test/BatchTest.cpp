@@ -0,0 +1,63 @@
+#include <stdexcept>
+#include <vector>
+
+#include "Testing.h"
+#include "game/engine/Batch.h"
+#include "game/snake/exception.h"
+
+using namespace game;
+
+/** @brief N games stepped by a Batch end exactly like the same N games run one after the other. */
+int main() {
+    constexpr size_t GAMES = 300;
+    constexpr uint64_t MAX_TICKS = 5000;
+    constexpr snake::Seed SEED = 42;
+
+    worker::Worker pool(4);
+    engine::Batch batch(GAMES, 24, 16, SEED, pool);
+    CHECK(batch.size() == GAMES);
+
+    std::vector<engine::Orientation> actions(GAMES);
+    for (uint64_t tick = 0; tick < MAX_TICKS; ++tick) {
+        for (size_t i = 0; i < GAMES; ++i) actions[i] = test::greedy(batch[i]);
+        batch.step(actions);
+    }
+
+    size_t over = 0;
+    for (size_t i = 0; i < GAMES; ++i) {
+        engine::Engine sequential(24, 16, SEED + i);
+        sequential.run(test::greedy, MAX_TICKS);
+        CHECK(batch[i].ticks() == sequential.ticks());
+        CHECK(batch[i].last() == sequential.last());
+        CHECK(batch[i].hash() == sequential.hash());
+        over += sequential.over();
+    }
+    // Every game must end before MAX_TICKS, so that the final Outcomes are compared too
+    CHECK(over == GAMES);
+
+    // One action missing, nothing is stepped
+    bool refused = false;
+    try {
+        batch.step(std::span(actions).first(GAMES - 1));
+    } catch (std::invalid_argument const &) {
+        refused = true;
+    }
+    CHECK(refused);
+
+    // Boards too small are refused before anything is allocated or written
+    for (auto [width, height] : {std::pair<size_t, size_t>{24, 1}, {0, 0}, {1, 16}, {9, 10}}) {
+        refused = false;
+        try {
+            engine::Batch(1, width, height, SEED, pool);
+        } catch (snake::exception::SnakeSmallMatrixException const &) {
+            refused = true;
+        }
+        CHECK(refused);
+    }
+
+    // A reset game plays again from the start
+    batch.reset(0, SEED);
+    CHECK(batch[0].ticks() == 0);
+    CHECK(batch[0].hash() == engine::Engine(24, 16, SEED).hash());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "Testing.h"
+#include "game/snake/Bitboard.h"
+
+using namespace game;
+using snake::Bitboard;
+
+namespace {
+    /** @brief Reference flood fill, one cell at a time. */
+    size_t bfs(Bitboard const &board, size_t width, size_t height, size_t x, size_t y) {
+        if (board.blocked(x, y)) return 0;
+        std::vector<bool> seen(width * height);
+        std::queue<std::pair<size_t, size_t>> queue;
+        queue.emplace(x, y);
+        seen[x + y * width] = true;
+        size_t count = 0;
+        while (!queue.empty()) {
+            auto [cx, cy] = queue.front();
+            queue.pop();
+            ++count;
+            auto visit = [&](size_t nx, size_t ny) {
+                if (nx >= width || ny >= height || seen[nx + ny * width] || board.blocked(nx, ny)) return;
+                seen[nx + ny * width] = true;
+                queue.emplace(nx, ny);
+            };
+            visit(cx - 1, cy);  // wraps around to a huge x at the left border
+            visit(cx + 1, cy);
+            visit(cx, cy - 1);
+            visit(cx, cy + 1);
+        }
+        return count;
+    }
+}  // namespace
+
+/** @brief Every reachable() kernel counts the same cells as a plain breadth-first search, whatever the width. */
+int main() {
+    std::vector<Bitboard::Kernel> kernels{Bitboard::Kernel::SCALAR};
+    if (Bitboard::kernel() == Bitboard::Kernel::AVX2) kernels.push_back(Bitboard::Kernel::AVX2);
+
+    std::mt19937 rng(24);
+    size_t queries = 0;
+    // Around one word per row, and around the 4 words of an AVX2 register
+    for (size_t width : {1, 2, 10, 63, 64, 65, 100, 127, 128, 129, 255, 256, 257, 300, 511, 513}) {
+        for (size_t height : {1, 2, 17, 64}) {
+            for (unsigned density : {10, 35, 45, 60}) {
+                Bitboard board(width, height);
+                for (size_t y = 0; y < height; ++y) {
+                    for (size_t x = 0; x < width; ++x) board.set(x, y, rng() % 100 < density);
+                }
+                for (int i = 0; i < 8; ++i) {
+                    auto x = rng() % width, y = rng() % height;
+                    auto expected = bfs(board, width, height, x, y);
+                    for (auto kernel : kernels) CHECK(board.reachable(kernel, x, y) == expected);
+                    CHECK(board.reachable(x, y) == expected);
+                    ++queries;
+                }
+            }
+        }
+    }
+    std::printf("%zu queries, kernel: %s\n", queries, Bitboard::toString(Bitboard::kernel()));
+    return EXIT_SUCCESS;
+}
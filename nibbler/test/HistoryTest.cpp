@@ -0,0 +1,52 @@
+#include <vector>
+
+#include "Testing.h"
+#include "game/snake/exception.h"
+
+using namespace game;
+
+/** @brief A game rewound K ticks, then given the same inputs again, goes through exactly the same boards. */
+int main() {
+    constexpr uint64_t TICKS = 200, DEPTH = 64;  // DEPTH snapshots: the current tick and DEPTH - 1 before it
+
+    engine::Engine game(24, 16, 98);
+    game.keep_history(DEPTH);
+    std::vector<engine::Orientation> inputs;
+    std::vector<uint64_t> hashes{game.hash()};
+    while (game.ticks() < TICKS && !game.over()) {
+        inputs.push_back(test::greedy(game));
+        game.step(inputs.back());
+        hashes.push_back(game.hash());
+    }
+    CHECK(game.ticks() == TICKS);
+
+    for (uint64_t k : {uint64_t(1), uint64_t(7), DEPTH - 1}) {
+        game.rewind(TICKS - k);
+        CHECK(game.ticks() == TICKS - k);
+        CHECK(game.hash() == hashes[TICKS - k]);
+        // Food placement included: the same inputs give the same boards
+        for (auto tick = TICKS - k; tick < TICKS; ++tick) {
+            game.step(inputs[tick]);
+            CHECK(game.hash() == hashes[tick + 1]);
+        }
+    }
+
+    // Rewound games keep going like one that never was
+    engine::Engine reference(24, 16, 98);
+    for (auto input : inputs) reference.step(input);
+    game.run(test::greedy, 5000);
+    reference.run(test::greedy, 5000);
+    CHECK(game.over());
+    CHECK(game.ticks() == reference.ticks());
+    CHECK(game.hash() == reference.hash());
+
+    // Older ticks are dropped, later ones are not there yet
+    bool refused = false;
+    try {
+        game.rewind(game.ticks() - DEPTH);
+    } catch (snake::exception::HistoryRangeException const &) {
+        refused = true;
+    }
+    CHECK(refused);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Recording.h"
+#include "Testing.h"
+
+using namespace interface::recording;
+
+/**
+ * @brief A headless game with the recorder plugin, driven by NIBBLER_RECORDER_INPUT, gets past the menu and records
+ * game frames, then exits on its own.
+ *
+ * Usage: RecorderTest <nibbler> <librecorder-plugin.so>
+ */
+int main(int ac, char const *av[]) {
+    CHECK(ac == 3);
+    auto const path = std::string("RecorderTest.rec");
+    setenv("NIBBLER_RECORDER_PATH", path.c_str(), 1);
+    setenv("NIBBLER_RECORDER_INPUT", "ENTER,ENTER,200,ESC", 1);
+    auto const command = std::string(av[1]) + " " + av[2] + " > RecorderTest.log 2>&1";
+    CHECK(std::system(command.c_str()) == 0);
+
+    std::ifstream in(path, std::ios::binary);
+    FileHeader header{};
+    CHECK(in.read(reinterpret_cast<char *>(&header), sizeof(header)));
+    CHECK(std::equal(std::begin(MAGIC), std::end(MAGIC), header.magic));
+    auto const head = header.head.load();
+
+    size_t menus = 0, games = 0;
+    std::vector<char> slot(header.slot_size);
+    for (uint32_t i = 0; i < header.slot_count; ++i) {
+        CHECK(in.read(slot.data(), static_cast<std::streamsize>(slot.size())));
+        auto const &s = *reinterpret_cast<SlotHeader const *>(slot.data());
+        auto const seq = s.seq.load();
+        if (!seq) continue;  // never written
+        CHECK(seq % 2 == 0 && seq / 2 <= head);
+        if (s.kind == FrameKind::MENU) ++menus;
+        if (s.kind == FrameKind::GAME) {
+            CHECK(s.extent.width && s.extent.height);
+            CHECK(s.size == s.extent.width * s.extent.height * sizeof(interface::ARGB));
+            ++games;
+        }
+    }
+    // The menu is shown first, the game frames follow it
+    CHECK(head > 1);
+    CHECK(games > 0);
+    std::printf("%lu frames, the last %zu menu and %zu game frames kept\n", head, menus, games);
+    return EXIT_SUCCESS;
+}
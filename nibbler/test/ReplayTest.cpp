@@ -0,0 +1,81 @@
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include "Testing.h"
+#include "game/engine/Replay.h"
+#include "game/engine/exception.h"
+
+using namespace game;
+using engine::Replay;
+using engine::ReplayRecord;
+
+namespace {
+    constexpr char const *PATH = "ReplayTest.replay";
+
+    void save(Replay const &replay) {
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<char const *>(&replay.header), sizeof(replay.header));
+        for (auto const &record : replay.records) out.write(reinterpret_cast<char const *>(&record), sizeof(record));
+    }
+
+    /** @return The replay file, once corrupted by f, is refused by Replay::load(). */
+    bool refused(Replay replay, std::function<void(Replay &)> const &f) {
+        f(replay);
+        save(replay);
+        try {
+            Replay::load(PATH);
+        } catch (engine::exception::ReplayFormatException const &) {
+            return true;
+        }
+        return false;
+    }
+}  // namespace
+
+/** @brief A game recorded by a ReplayWriter plays again to the same end, and corrupted replays are refused. */
+int main() {
+    engine::Engine game(24, 16, 1234);
+    {
+        engine::ReplayWriter writer(PATH, game);
+        auto orientation = engine::Orientation::SOUTH;
+        writer.turn(0, orientation, 0);  // Like PlayingState: the Player starts heading south
+        while (!game.over()) {
+            auto const wanted = test::greedy(game);
+            if (wanted != orientation) writer.turn(game.ticks(), orientation = wanted, game.ticks());
+            game.step(orientation);
+        }
+        writer.end(game);
+    }
+    CHECK(game.ticks() > 100);
+
+    auto const replay = Replay::load(PATH);
+    auto const result = engine::play(replay);
+    CHECK(result.matches);
+    CHECK(result.ticks == game.ticks());
+    CHECK(result.outcome == game.last());
+    CHECK(result.hash == game.hash());
+
+    // A perpendicular turn along the way ends elsewhere
+    auto diverged = replay;
+    diverged.records[1].value ^= 2;
+    CHECK(!engine::play(diverged).matches);
+
+    CHECK(refused(replay, [](Replay &r) { r.header.width = 9; }));
+    CHECK(refused(replay, [](Replay &r) { r.header.width = r.header.height = 100000; }));
+    CHECK(refused(replay, [](Replay &r) { std::swap(r.records[1].tick, r.records[2].tick); }));
+    CHECK(refused(replay, [](Replay &r) { r.records[1].value = 4; }));
+    CHECK(refused(replay, [](Replay &r) { r.records[1].kind = static_cast<ReplayRecord::Kind>(2); }));
+    CHECK(refused(replay, [](Replay &r) { r.records.back().value = 0xFF; }));
+    CHECK(refused(replay, [](Replay &r) { r.records.pop_back(); }));
+    CHECK(refused(replay, [](Replay &r) { r.records.push_back(r.records.front()); }));
+    CHECK(refused(replay, [](Replay &r) { r.records.insert(r.records.begin(), r.records.back()); }));
+    // A truncated record
+    save(replay);
+    { std::ofstream(PATH, std::ios::binary | std::ios::app).write("\0\0\0", 3); }
+    try {
+        Replay::load(PATH);
+        CHECK(false);
+    } catch (engine::exception::ReplayFormatException const &) {
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "game/engine/Engine.h"
+
+/** @brief Fail the test when cond does not hold. Unlike assert(), it is never compiled out. */
+#define CHECK(cond)                                                                          \
+    do {                                                                                     \
+        if (!(cond)) {                                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);    \
+            std::exit(EXIT_FAILURE);                                                         \
+        }                                                                                    \
+    } while (false)
+
+namespace game::test {
+    using engine::Engine;
+    using engine::Orientation;
+
+    /** @return The cell next to (x, y) in the direction o. */
+    inline std::pair<size_t, size_t> next(size_t x, size_t y, Orientation o) {
+        switch (o) {
+            case Orientation::NORTH: return {x, y - 1};
+            case Orientation::SOUTH: return {x, y + 1};
+            case Orientation::EAST: return {x + 1, y};
+            case Orientation::WEST: return {x - 1, y};
+        }
+        return {x, y};
+    }
+
+    /**
+     * @brief Deterministic controller for Engine::run(): heads for the food, turning away from blocked cells, until
+     * it traps itself. Games last a few hundred ticks, eat a few dozen foods and die, and only depend on the Engine.
+     */
+    inline Orientation greedy(Engine const &engine) {
+        static constexpr Orientation ORDER[] = {Orientation::NORTH, Orientation::EAST, Orientation::SOUTH,
+                                                Orientation::WEST};
+        auto const &board = engine.snake()._board;
+        auto [x, y] = engine.snake()._player.head();
+        auto fx = board.food() % board.width(), fy = board.food() / board.width();
+        auto wanted = fx != x ? (fx > x ? Orientation::EAST : Orientation::WEST)
+                              : (fy > y ? Orientation::SOUTH : Orientation::NORTH);
+        if (auto [nx, ny] = next(x, y, wanted); !board.occupancy().blocked(nx, ny)) return wanted;
+        for (auto o : ORDER) {
+            if (auto [nx, ny] = next(x, y, o); !board.occupancy().blocked(nx, ny)) return o;
+        }
+        return wanted;
+    }
+}  // namespace game::test
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "Testing.h"
+#include "game/render/Frame.h"
+#include "game/render/Upscale.h"
+
+using namespace game;
+using render::Isa;
+
+namespace {
+    /** @brief Every instruction set the CPU supports: each one implies the previous ones */
+    std::vector<Isa> supported() {
+        std::vector<Isa> isas{Isa::SCALAR};
+        if (render::isa() >= Isa::SSE2) isas.push_back(Isa::SSE2);
+        if (render::isa() >= Isa::AVX2) isas.push_back(Isa::AVX2);
+        return isas;
+    }
+}  // namespace
+
+/** @brief Every expand_row() kernel writes exactly the same pixels, and nothing past count * scale. */
+int main() {
+    constexpr render::ARGB GUARD = 0xDEADBEEF;
+    constexpr render::Palette PALETTE = {0x00000001, 0x00000002, 0x00000003, 0x00000004, 0x00000005};
+
+    std::mt19937 rng(7);
+    std::vector<snake::Entity> cells(300);
+    for (auto &cell : cells) cell = static_cast<snake::Entity>(rng() % snake::ENTITY_COUNT);
+
+    auto const isas = supported();
+    // Counts and scales around the 4 and 8 lanes of SSE2 and AVX2, so that every tail loop runs
+    for (size_t count = 0; count <= 67; ++count) {
+        for (uint32_t scale = 1; scale <= 17; ++scale) {
+            std::vector<render::ARGB> expected(count * scale + 1, GUARD);
+            render::expand_row(Isa::SCALAR, cells.data() + count % 5, count, PALETTE, scale, expected.data());
+            for (size_t i = 0; i < count * scale; ++i) {
+                CHECK(expected[i] == render::colour(PALETTE, cells[count % 5 + i / scale]));
+            }
+            CHECK(expected.back() == GUARD);
+            for (auto isa : isas) {
+                std::vector<render::ARGB> pixels(count * scale + 1, GUARD);
+                render::expand_row(isa, cells.data() + count % 5, count, PALETTE, scale, pixels.data());
+                CHECK(pixels == expected);
+            }
+        }
+    }
+
+    // A full redraw of a 20x20 board on an 800x600 display, 40x30 pixels per cell, with the kernel picked at runtime
+    snake::Snake game(20, 20, 1);
+    render::Frame frame({.width = 20, .height = 20}, {.width = 40, .height = 30});
+    constexpr int FRAMES = 1000;
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FRAMES; ++i) frame.draw(game._board.matrix(), game._board.damage(), true);
+    auto const elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    CHECK(frame.buffer()[0] == render::WHITE);
+    std::printf("%s: %.1fus per full 800x600 frame\n", render::toString(render::isa()), elapsed.count() / FRAMES);
+    return EXIT_SUCCESS;
+}